@@ -6,9 +6,13 @@
 #define BALANCED_SORT_H
 
 #include <vector>
+#include <cstddef>
+
+#include "perf_counters.hpp"
 
 template<typename T>
-std::vector<T> balanced_sort(std::vector<T> data, int num_files, int mem_size, bool verbose = true);
+std::vector<T> balanced_sort(std::vector<T> data, std::size_t num_files, std::size_t mem_size, bool verbose = true,
+	PhaseProfiler* profiler = nullptr);
 
 // include template implementations
 #include "balanced_sort.tpp"
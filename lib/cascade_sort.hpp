@@ -6,9 +6,16 @@
 #define CASCADE_SORT_HPP
 
 #include <vector>
+#include <cstddef>
 
+#include "checkpoint.hpp"
+#include "perf_counters.hpp"
+
+// with a checkpoint, the tapes are saved after run formation and every phase, which adds a full
+// write of the records per phase (see Checkpoint)
 template<typename T>
-std::vector<T> cascade_sort(std::vector<T> data, int num_files, int mem_size, bool verbose = true);
+std::vector<T> cascade_sort(std::vector<T> data, std::size_t num_files, std::size_t mem_size, bool verbose = true,
+	PhaseProfiler* profiler = nullptr, Checkpoint* checkpoint = nullptr);
 
 // include template implementations
 #include "cascade_sort.tpp"
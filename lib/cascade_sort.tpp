@@ -5,8 +5,12 @@
 #include <iostream>
 #include <utility>
 #include <vector>
+#include <limits>
 
 #include "initial_distribution.tpp"
+#include "merge_kernel.hpp"
+#include "checkpoint.hpp"
+#include "perf_counters.hpp"
 #include "utils.hpp"
 
 using std::vector, std::pair, std::make_pair;
@@ -14,36 +18,19 @@ using std::vector, std::pair, std::make_pair;
 // merge a single run from each select file
 // returns number of writes
 template<typename T>
-int merge_single_run(
+size_t merge_single_run(
     vector<vector<vector<T>>>& files,
-    const vector<int> merge_ids,
-    int output_id,
-    const int mem_size
+    const vector<size_t>& merge_ids,
+    size_t output_id,
+    const size_t mem_size
 ) {
-    int writes = 0;
-    min_priority_queue<pair<T, int>> min_heap;
-
-    vector<T> run;
-    // merge
-    vector<int> ptrs(files.size(), 0);
+    vector<const vector<T>*> runs;
     for (auto id: merge_ids) {
-        T item = files[id][0][0];
-        min_heap.push(make_pair(item, id));
-        ++ptrs[id];
-    }
-
-    while (!min_heap.empty()) {
-        auto[item, id] = min_heap.top();
-        min_heap.pop();
-        run.emplace_back(item);
-        ++writes;
-        if (ptrs[id] < files[id][0].size()) {
-            T new_item = files[id][0][ptrs[id]];
-            min_heap.push(make_pair(new_item, id));
-            ++ptrs[id];
-        }
+        runs.emplace_back(&files[id][0]);
     }
-    files[output_id].emplace_back(run);
+    vector<T> run;
+    const size_t writes = merge_runs(runs, run);
+    files[output_id].emplace_back(std::move(run));
 
     for (auto id : merge_ids) {
         files[id].erase(files[id].begin());
@@ -51,20 +38,38 @@ int merge_single_run(
     return writes;
 }
 
+// count-only version: merges the run lengths at the front of each selected tape
+// returns number of writes
+inline size_t merge_single_run(
+    vector<RunLengthTape>& files,
+    const vector<size_t>& merge_ids,
+    size_t output_id,
+    const size_t /* mem_size */
+) {
+    size_t writes = 0;
+    for (auto id: merge_ids) {
+        writes += files[id].front();
+        files[id].pop_front();
+    }
+    files[output_id].emplace_back(writes);
+    return writes;
+}
+
 // single step
 // returns number of writes
-template<typename T>
-int merge_step(
-    vector<vector<vector<T>>>& files,
-    const int mem_size
+template<typename Tape>
+size_t merge_step(
+    vector<Tape>& files,
+    const size_t mem_size
 ) {
-    constexpr int INF = std::numeric_limits<int>::max();
+    constexpr size_t INF = std::numeric_limits<size_t>::max();
+    constexpr size_t NONE = std::numeric_limits<size_t>::max();
 
-    vector<int> merge_ids;
-    int output_id = -1;
+    vector<size_t> merge_ids;
+    size_t output_id = NONE;
     size_t min_merge_steps = INF;
     for (size_t i = 0; i < files.size(); ++i) {
-        if (files[i].size() == 0 && output_id == -1) {
+        if (files[i].size() == 0 && output_id == NONE) {
             output_id = i;
         }
         else if (files[i].size() > 0) {
@@ -73,19 +78,19 @@ int merge_step(
         }
     }
 
-    int writes = 0;
+    size_t writes = 0;
     while (!merge_ids.empty()) {
-        for (int i = 0; i < min_merge_steps; ++i) {
+        for (size_t i = 0; i < min_merge_steps; ++i) {
             writes += merge_single_run(files, merge_ids, output_id, mem_size);
         }
-        vector<int> remaining_merge_ids;
-        output_id = -1;
+        vector<size_t> remaining_merge_ids;
+        output_id = NONE;
         min_merge_steps = INF;
         for (auto id: merge_ids) {
             if (files[id].size() > 0) {
                 remaining_merge_ids.emplace_back(id);
                 min_merge_steps = std::min(min_merge_steps, files[id].size());
-            } else if (files[id].size() == 0 && output_id == -1) {
+            } else if (files[id].size() == 0 && output_id == NONE) {
                 output_id = id;
             }
         }
@@ -94,10 +99,9 @@ int merge_step(
     return writes;
 }
 
-template<typename T>
-bool is_finished(const vector<vector<T>> &files) {
-    bool finished = true;
-    int num_runs = 0;
+template<typename Tape>
+bool is_finished(const vector<Tape> &files) {
+    size_t num_runs = 0;
     for (size_t i = 0; i < files.size(); ++i) {
         num_runs += files[i].size();
     }
@@ -108,28 +112,39 @@ bool is_finished(const vector<vector<T>> &files) {
 template<typename T>
 pair<vector<T>, double> _cascade_sort_from_initial(
     vector<vector<vector<T>>>& files,
-    const int mem_size,
-    const bool verbose
+    const size_t mem_size,
+    const bool verbose,
+    PhaseProfiler* profiler = nullptr,
+    Checkpoint* checkpoint = nullptr
 ) {
-    int writes = 0;
-    int n = 0;
+    // phases already done by an interrupted run of this sort (0 if starting from the initial runs)
+    const size_t phases_done = checkpoint ? checkpoint->phase() : 0;
+    size_t writes = checkpoint ? checkpoint->writes() : 0;
+    size_t n = 0;
     for (const auto& file: files) {
         for (const auto& run: file) {
             n += run.size();
         }
     }
-    const int num_files = files.size();
+    const size_t num_files = files.size();
     Observer watcher(std::cout);
+    watcher.step = phases_done;
 
-    while (!is_finished(files)) {
-        writes += merge_step(files, mem_size);
-        writes += redistribute_if_needed(files);
+    for (size_t phase = phases_done + 1; !is_finished(files); phase++) {
+        if (profiler) profiler->begin("merge " + std::to_string(phase));
+        size_t phase_writes = merge_step(files, mem_size);
+        phase_writes += redistribute_if_needed(files);
+        if (profiler) profiler->end(phase_writes);
+        writes += phase_writes;
+        if (checkpoint) {
+            checkpoint->save(SortMethod::Cascade, mem_size, files, phase, writes);
+        }
         if (verbose) {
             watcher.register_step(files, mem_size);
         }
     }
     // find last run
-    for (int i = 0; i < num_files; ++i) {
+    for (size_t i = 0; i < num_files; ++i) {
         if (files[i].size() > 0) {
             return {files[i][0], double(writes) / double(n)};
         }
@@ -138,22 +153,41 @@ pair<vector<T>, double> _cascade_sort_from_initial(
 
 template<typename T>
 vector<T> cascade_sort(
-    const vector<T> data, const int num_files,
-    const int mem_size, const bool verbose
+    const vector<T> data, const size_t num_files,
+    const size_t mem_size, const bool verbose,
+    PhaseProfiler* profiler,
+    Checkpoint* checkpoint
 ) {
-    // initial runs
-    vector<vector<vector<T>>> files(num_files - 1);
+    vector<vector<vector<T>>> files;
     Observer watcher(std::cout);
-    perform_initial_distribution(data, files, mem_size);
-    // add extra file for merging
-    files.emplace_back();
-    if (verbose) {
-        watcher.register_step(files, mem_size);
+    // input the manifests of this sort are saved for
+    const InputDigest input = checkpoint ? InputDigest::of(data) : InputDigest();
+    if (checkpoint && checkpoint->exists()) {
+        // resume an interrupted sort of the same input from its last completed phase
+        files = checkpoint->load<T>(SortMethod::Cascade, num_files, mem_size, input);
+    } else {
+        // initial runs
+        files.resize(num_files - 1);
+        if (profiler) profiler->begin("runs");
+        perform_initial_distribution(data, files, mem_size);
+        if (profiler) profiler->end(data.size());
+        // add extra file for merging
+        files.emplace_back();
+        if (verbose) {
+            watcher.register_step(files, mem_size);
+        }
+        if (checkpoint) {
+            checkpoint->set_input(input);
+            checkpoint->save(SortMethod::Cascade, mem_size, files, 0, 0);
+        }
     }
 
     auto[sorted_data, avg_writes] = _cascade_sort_from_initial(
-        files, mem_size, verbose
+        files, mem_size, verbose, profiler, checkpoint
     );
+    if (checkpoint) {
+        checkpoint->clear();
+    }
 
     // print final average
     if (verbose) {
@@ -0,0 +1,96 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils.hpp"
+
+// number of records and FNV-1a hash of their bytes, identifying the input a manifest was made for
+struct InputDigest {
+	std::uint64_t records = 0;
+	std::uint64_t hash = 0;
+
+	// throws std::invalid_argument if T may have padding bytes
+	// (neither std::has_unique_object_representations_v<T> nor a floating point type)
+	template<typename T>
+	static InputDigest of(const std::vector<T>& data);
+
+	bool operator==(const InputDigest& other) const {
+		return records == other.records && hash == other.hash;
+	}
+};
+
+// manifest of a polyphasic or cascade sort at its last completed phase: every tape with its runs,
+// the number of phases done, the writes so far and the digest of the input, saved to a single file
+// at each phase boundary
+// every save rewrites and fsyncs the whole dataset: a sort of n records over p merge phases
+// writes O(p * n) extra records to the manifest (one full copy after run formation and after
+// each phase), as many again as the sort itself writes
+// a restarted sort given the same Checkpoint and the same input resumes from the manifest instead
+// of from the input; a manifest made for another input is rejected, never applied to it
+// records are stored as raw bytes, so T must be trivially copyable, and the input is identified
+// by those bytes, so T must not have padding either (see InputDigest::of)
+class Checkpoint {
+public:
+	explicit Checkpoint(std::string path) : file(std::move(path)) {}
+
+	const std::string& path() const {
+		return file;
+	}
+
+	// true if there is a manifest to resume from
+	bool exists() const;
+
+	// merge phases completed and writes made up to the last save / load (0 for a new sort)
+	std::size_t phase() const {
+		return completed_phases;
+	}
+
+	std::size_t writes() const {
+		return total_writes;
+	}
+
+	// input the saved manifests belong to (set by the sort before its first save, or by load)
+	const InputDigest& input() const {
+		return input_digest;
+	}
+
+	void set_input(const InputDigest& input) {
+		input_digest = input;
+	}
+
+	// replaces the manifest atomically (written aside, then renamed over the old one)
+	template<typename T>
+	void save(
+		SortMethod method, std::size_t mem_size, const std::vector<std::vector<std::vector<T>>>& files,
+		std::size_t phase, std::size_t writes
+	);
+
+	// reads back the tapes of the manifest
+	// throws std::invalid_argument if it belongs to a sort with other parameters or another input,
+	// std::runtime_error if it is missing or corrupt
+	template<typename T>
+	std::vector<std::vector<std::vector<T>>> load(
+		SortMethod method, std::size_t num_files, std::size_t mem_size, const InputDigest& input
+	);
+
+	// removes the manifest (once the sort is done)
+	void clear();
+
+private:
+	std::string file;
+	std::size_t completed_phases = 0, total_writes = 0;
+	InputDigest input_digest;
+};
+
+// include template implementations
+#include "checkpoint.tpp"
+
+#endif //CHECKPOINT_HPP
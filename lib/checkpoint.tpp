@@ -0,0 +1,219 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "utils.hpp"
+
+using std::vector;
+
+namespace CheckpointDetail {
+	constexpr char MAGIC[8] = {'E', 'X', 'T', 'S', 'O', 'R', 'T', '2'};
+
+	// all header fields and lengths are stored as 64-bit integers
+	inline void write_all(std::FILE* out, const void* data, const size_t size, const std::string& path) {
+		if (size > 0 && std::fwrite(data, 1, size, out) != size) {
+			std::fclose(out);
+			throw std::runtime_error("could not write checkpoint " + path);
+		}
+	}
+
+	inline void write_u64(std::FILE* out, const std::uint64_t value, const std::string& path) {
+		write_all(out, &value, sizeof(value), path);
+	}
+
+	inline void read_all(std::FILE* in, void* data, const size_t size, const std::string& path) {
+		if (size > 0 && std::fread(data, 1, size, in) != size) {
+			std::fclose(in);
+			throw std::runtime_error("truncated checkpoint " + path);
+		}
+	}
+
+	inline std::uint64_t read_u64(std::FILE* in, const std::string& path) {
+		std::uint64_t value;
+		read_all(in, &value, sizeof(value), path);
+		return value;
+	}
+}
+
+template<typename T>
+InputDigest InputDigest::of(const vector<T>& data) {
+	static_assert(std::is_trivially_copyable_v<T>, "checkpointed records must be trivially copyable");
+	// padding bytes are indeterminate, so equal inputs could hash differently; floating point types
+	// have no padding (only several encodings of some values, each of which hashes the same every time)
+	if constexpr (std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>) {
+		// 64-bit FNV-1a
+		std::uint64_t hash = 0xcbf29ce484222325ull;
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+		for (size_t i = 0; i < data.size() * sizeof(T); i++) {
+			hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+		}
+		return {data.size(), hash};
+	} else {
+		throw std::invalid_argument("records with padding bytes cannot be checkpointed");
+	}
+}
+
+inline bool Checkpoint::exists() const {
+	std::FILE* in = std::fopen(file.c_str(), "rb");
+	if (in == nullptr) {
+		return false;
+	}
+	std::fclose(in);
+	return true;
+}
+
+template<typename T>
+void Checkpoint::save(
+	const SortMethod method, const size_t mem_size, const vector<vector<vector<T>>>& files,
+	const size_t phase, const size_t writes
+) {
+	static_assert(std::is_trivially_copyable_v<T>, "checkpointed records must be trivially copyable");
+	using namespace CheckpointDetail;
+
+	// a crash while writing leaves the previous manifest untouched
+	const std::string temporary = file + ".tmp";
+	std::FILE* out = std::fopen(temporary.c_str(), "wb");
+	if (out == nullptr) {
+		throw std::runtime_error("could not create checkpoint " + temporary);
+	}
+	write_all(out, MAGIC, sizeof(MAGIC), temporary);
+	write_u64(out, sizeof(T), temporary);
+	write_u64(out, static_cast<std::uint64_t>(method), temporary);
+	write_u64(out, mem_size, temporary);
+	write_u64(out, phase, temporary);
+	write_u64(out, writes, temporary);
+	write_u64(out, input_digest.records, temporary);
+	write_u64(out, input_digest.hash, temporary);
+	write_u64(out, files.size(), temporary);
+	for (const auto& tape: files) {
+		write_u64(out, tape.size(), temporary);
+		for (const auto& run: tape) {
+			write_u64(out, run.size(), temporary);
+			write_all(out, run.data(), run.size() * sizeof(T), temporary);
+		}
+	}
+	bool flushed = std::fflush(out) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+	flushed = flushed && fsync(fileno(out)) == 0;
+#endif
+	if (std::fclose(out) != 0 || !flushed || std::rename(temporary.c_str(), file.c_str()) != 0) {
+		throw std::runtime_error("could not write checkpoint " + file);
+	}
+#if defined(__unix__) || defined(__APPLE__)
+	// the rename itself is only durable once the directory holding the manifest is synced
+	const size_t slash = file.find_last_of('/');
+	const std::string directory = (slash == std::string::npos) ? "." : (slash == 0) ? "/" : file.substr(0, slash);
+	const int directory_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (directory_fd < 0) {
+		throw std::runtime_error("could not open the directory of checkpoint " + file);
+	}
+	const bool synced = fsync(directory_fd) == 0;
+	close(directory_fd);
+	if (!synced) {
+		throw std::runtime_error("could not sync the directory of checkpoint " + file);
+	}
+#endif
+	completed_phases = phase;
+	total_writes = writes;
+}
+
+template<typename T>
+vector<vector<vector<T>>> Checkpoint::load(
+	const SortMethod method, const size_t num_files, const size_t mem_size, const InputDigest& input
+) {
+	static_assert(std::is_trivially_copyable_v<T>, "checkpointed records must be trivially copyable");
+	using namespace CheckpointDetail;
+
+	std::FILE* in = std::fopen(file.c_str(), "rb");
+	if (in == nullptr) {
+		throw std::runtime_error("could not open checkpoint " + file);
+	}
+	char magic[sizeof(MAGIC)];
+	read_all(in, magic, sizeof(magic), file);
+	if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+		std::fclose(in);
+		throw std::runtime_error(file + " is not a sort checkpoint");
+	}
+	const std::uint64_t record_size = read_u64(in, file);
+	const std::uint64_t saved_method = read_u64(in, file);
+	const std::uint64_t saved_mem_size = read_u64(in, file);
+	const std::uint64_t phase = read_u64(in, file);
+	const std::uint64_t writes = read_u64(in, file);
+	InputDigest saved_input;
+	saved_input.records = read_u64(in, file);
+	saved_input.hash = read_u64(in, file);
+	const std::uint64_t saved_num_files = read_u64(in, file);
+	if (
+		record_size != sizeof(T) || saved_method != static_cast<std::uint64_t>(method)
+		|| saved_mem_size != mem_size || saved_num_files != num_files
+	) {
+		std::fclose(in);
+		throw std::invalid_argument("checkpoint " + file + " belongs to a sort with other parameters");
+	}
+	if (!(saved_input == input)) {
+		std::fclose(in);
+		throw std::invalid_argument("checkpoint " + file + " belongs to a sort of another input");
+	}
+
+	// bytes left after the current position, to reject corrupt lengths before allocating
+	const long position = std::ftell(in);
+	std::fseek(in, 0, SEEK_END);
+	const long size = std::ftell(in);
+	std::fseek(in, position, SEEK_SET);
+	auto check_length = [&](const std::uint64_t length, const size_t item_size) {
+		if (length > std::uint64_t(size - std::ftell(in)) / item_size) {
+			std::fclose(in);
+			throw std::runtime_error("corrupt checkpoint " + file);
+		}
+		return length;
+	};
+
+	vector<vector<vector<T>>> files(num_files);
+	for (auto& tape: files) {
+		tape.resize(check_length(read_u64(in, file), sizeof(std::uint64_t)));
+		for (auto& run: tape) {
+			const size_t length = check_length(read_u64(in, file), sizeof(T));
+			if constexpr (std::is_default_constructible_v<T>) {
+				run.resize(length);
+				read_all(in, run.data(), length * sizeof(T), file);
+			} else {
+				// no default value to resize with: copy each record out of the raw bytes
+				vector<unsigned char> bytes(length * sizeof(T));
+				read_all(in, bytes.data(), bytes.size(), file);
+				run.reserve(length);
+				for (size_t i = 0; i < length; i++) {
+					alignas(T) unsigned char record[sizeof(T)];
+					std::memcpy(record, bytes.data() + i * sizeof(T), sizeof(T));
+					run.push_back(*std::launder(reinterpret_cast<const T*>(record)));
+				}
+			}
+		}
+	}
+	std::fclose(in);
+	completed_phases = phase;
+	total_writes = writes;
+	input_digest = input;
+	return files;
+}
+
+inline void Checkpoint::clear() {
+	std::remove(file.c_str());
+	completed_phases = 0;
+	total_writes = 0;
+	input_digest = InputDigest();
+}
@@ -0,0 +1,132 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef COLUMNAR_RECORDS_HPP
+#define COLUMNAR_RECORDS_HPP
+
+#include <vector>
+#include <tuple>
+#include <ostream>
+#include <cstddef>
+
+#include "dary_heap.hpp"
+#include "utils.hpp"
+
+// records with several sort keys, stored by column (one array per key and one for the payload)
+// row i is (key_column<0>()[i], ..., payload_column()[i]), ordered by its keys lexicographically
+template<typename Payload, typename... Keys>
+class ColumnarRecords {
+public:
+	static_assert(sizeof...(Keys) >= 1, "records need at least one sort key");
+	using LeadingKey = std::tuple_element_t<0, std::tuple<Keys...>>;
+
+	std::size_t size() const {
+		return payloads.size();
+	}
+
+	void reserve(std::size_t n);
+
+	void push_back(const Keys&... row_keys, const Payload& payload);
+
+	template<std::size_t I>
+	const auto& key_column() const {
+		return std::get<I>(keys);
+	}
+
+	const std::vector<Payload>& payload_column() const {
+		return payloads;
+	}
+
+	// true if row a comes before row b on the keys from the I-th on
+	// (a column is only read while all the previous ones tie)
+	template<std::size_t I = 0>
+	bool row_less(std::size_t a, std::size_t b) const;
+
+	// new records with the rows at `rows`, in that order
+	ColumnarRecords gather(const std::vector<std::size_t>& rows) const;
+
+	bool operator==(const ColumnarRecords& other) const {
+		return keys == other.keys && payloads == other.payloads;
+	}
+
+private:
+	std::tuple<std::vector<Keys>...> keys;
+	std::vector<Payload> payloads;
+};
+
+// what the sorts move around for a row: a copy of its leading key, so comparisons that it decides
+// never leave the handle, and where the row is, to read the other keys on ties
+// a handle carries its records, so it compares the same on any thread (e.g. the workers of hybrid_sort)
+template<typename Records>
+struct RowRef {
+	typename Records::LeadingKey lead;
+	std::size_t row;
+	const Records* records;
+
+	bool operator<(const RowRef& other) const {
+		if (lead < other.lead) return true;
+		if (other.lead < lead) return false;
+		return records->template row_less<1>(row, other.row);
+	}
+
+	bool operator>(const RowRef& other) const {
+		return other < *this;
+	}
+};
+
+// replacement selection keys of row handles: the run tag goes in the top bit of the row index,
+// so a heap key is no larger than the handle itself
+template<typename Records>
+struct RunTagged<RowRef<Records>> {
+	using Key = RowRef<Records>;
+	static constexpr std::size_t TAG = std::size_t(1) << (8 * sizeof(std::size_t) - 1);
+
+	static Key make(const Key& val, const bool tag) {
+		return Key{val.lead, tag ? (val.row | TAG) : val.row, val.records};
+	}
+
+	static Key value(const Key& key) {
+		return Key{key.lead, key.row & ~TAG, key.records};
+	}
+
+	static bool tag(const Key& key) {
+		return (key.row & TAG) != 0;
+	}
+
+	struct Less {
+		bool current = false;
+
+		void set_current_run(const bool parity) {
+			current = parity;
+		}
+
+		bool operator()(const Key& a, const Key& b) const {
+			const bool a_next = tag(a) != current, b_next = tag(b) != current;
+			if (a_next != b_next) {
+				return b_next;
+			}
+			return value(a) < value(b);
+		}
+	};
+};
+
+// rows are printed by their leading key (e.g. in the runs shown by the Observer)
+template<typename Records>
+std::ostream& operator<<(std::ostream& os, const RowRef<Records>& ref) {
+	return os << ref.lead;
+}
+
+// sorts `records` by their keys with `method` (as balanced_sort / polyphasic_sort / cascade_sort),
+// moving only row handles through run formation and the merges;
+// the key and payload columns are gathered once, in the final order
+template<typename Payload, typename... Keys>
+ColumnarRecords<Payload, Keys...> columnar_sort(
+	const ColumnarRecords<Payload, Keys...>& records, SortMethod method,
+	std::size_t num_files, std::size_t mem_size
+);
+
+// include template implementations
+#include "columnar_records.tpp"
+
+#endif //COLUMNAR_RECORDS_HPP
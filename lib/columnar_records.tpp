@@ -0,0 +1,95 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+
+#include "balanced_sort.hpp"
+#include "cascade_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "utils.hpp"
+
+using std::vector;
+
+template<typename Payload, typename... Keys>
+void ColumnarRecords<Payload, Keys...>::reserve(const size_t n) {
+	std::apply([n](auto&... columns) { (columns.reserve(n), ...); }, keys);
+	payloads.reserve(n);
+}
+
+template<typename Payload, typename... Keys>
+void ColumnarRecords<Payload, Keys...>::push_back(const Keys&... row_keys, const Payload& payload) {
+	std::apply([&](auto&... columns) { (columns.push_back(row_keys), ...); }, keys);
+	payloads.push_back(payload);
+}
+
+template<typename Payload, typename... Keys>
+template<size_t I>
+bool ColumnarRecords<Payload, Keys...>::row_less(const size_t a, const size_t b) const {
+	if constexpr (I == sizeof...(Keys)) {
+		// same keys
+		return false;
+	} else {
+		const auto& column = std::get<I>(keys);
+		if (column[a] < column[b]) return true;
+		if (column[b] < column[a]) return false;
+		return row_less<I + 1>(a, b);
+	}
+}
+
+template<typename Payload, typename... Keys>
+ColumnarRecords<Payload, Keys...> ColumnarRecords<Payload, Keys...>::gather(const vector<size_t>& rows) const {
+	ColumnarRecords result;
+	result.reserve(rows.size());
+	auto gather_column = [&rows](const auto& from, auto& to) {
+		for (const size_t row: rows) {
+			to.push_back(from[row]);
+		}
+	};
+	std::apply([&](auto&... columns) {
+		std::apply([&](const auto&... from) { (gather_column(from, columns), ...); }, keys);
+	}, result.keys);
+	gather_column(payloads, result.payloads);
+	return result;
+}
+
+template<typename Payload, typename... Keys>
+ColumnarRecords<Payload, Keys...> columnar_sort(
+	const ColumnarRecords<Payload, Keys...>& records, const SortMethod method,
+	const size_t num_files, const size_t mem_size
+) {
+	using Ref = RowRef<ColumnarRecords<Payload, Keys...>>;
+	if (records.size() == 0) {
+		return records;
+	}
+	const auto& leading = records.template key_column<0>();
+	vector<Ref> refs(records.size());
+	for (size_t i = 0; i < refs.size(); i++) {
+		refs[i] = {leading[i], i, &records};
+	}
+
+	vector<Ref> sorted;
+	switch (method) {
+		case SortMethod::Balanced:
+			sorted = balanced_sort(std::move(refs), num_files, mem_size, false);
+			break;
+		case SortMethod::Polyphasic:
+			sorted = polyphasic_sort(std::move(refs), num_files, mem_size, false);
+			break;
+		case SortMethod::Cascade:
+			sorted = cascade_sort(std::move(refs), num_files, mem_size, false);
+			break;
+		default:
+			throw std::invalid_argument("invalid sorting method");
+	}
+
+	vector<size_t> rows(sorted.size());
+	for (size_t i = 0; i < sorted.size(); i++) {
+		rows[i] = sorted[i].row;
+	}
+	return records.gather(rows);
+}
@@ -0,0 +1,229 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef DARY_HEAP_HPP
+#define DARY_HEAP_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <functional>
+#include <type_traits>
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// allocator returning memory that starts `Shift` bytes past a cache line boundary
+// (the bytes before it are allocated too, but never hold an object)
+template<typename T, std::size_t Shift = 0>
+struct AlignedAllocator {
+	using value_type = T;
+
+	template<typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Shift>;
+	};
+
+	AlignedAllocator() = default;
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Shift>&) {}
+
+	T* allocate(const std::size_t n) {
+		void* raw = ::operator new(n * sizeof(T) + Shift, std::align_val_t(CACHE_LINE_SIZE));
+		return reinterpret_cast<T*>(static_cast<unsigned char*>(raw) + Shift);
+	}
+
+	void deallocate(T* ptr, std::size_t) {
+		::operator delete(reinterpret_cast<unsigned char*>(ptr) - Shift, std::align_val_t(CACHE_LINE_SIZE));
+	}
+
+	template<typename U>
+	bool operator==(const AlignedAllocator<U, Shift>&) const { return true; }
+	template<typename U>
+	bool operator!=(const AlignedAllocator<U, Shift>&) const { return false; }
+};
+
+// number of children per node: 4 children fit in a cache line for keys up to 16 bytes
+// (8 children save a level but measured slower, the extra comparisons cost more than the miss)
+template<typename Key>
+constexpr std::size_t default_arity() {
+	if (sizeof(Key) <= CACHE_LINE_SIZE / 4) return 4;
+	return 2;
+}
+
+// min heap where each node has D children
+// the storage starts D - 1 slots past a cache line boundary, so that the D children of any node
+// start at a multiple of D slots from it (so they never straddle two cache lines when D * sizeof(Key) divides 64)
+// no key is ever default constructed
+template<typename Key, typename Compare = std::less<Key>, std::size_t D = default_arity<Key>()>
+class DaryHeap {
+	static_assert(D >= 2, "a heap node needs at least 2 children");
+	static constexpr std::size_t OFFSET = D - 1;
+
+public:
+	explicit DaryHeap(Compare compare = Compare()) : compare(compare) {}
+
+	bool empty() const {
+		return keys.empty();
+	}
+
+	std::size_t size() const {
+		return keys.size();
+	}
+
+	void reserve(const std::size_t n) {
+		keys.reserve(n);
+	}
+
+	const Key& top() const {
+		return keys[0];
+	}
+
+	void push(const Key& key) {
+		keys.push_back(key);
+		sift_up(size() - 1);
+	}
+
+	void pop() {
+		at(0) = keys.back();
+		keys.pop_back();
+		if (!empty()) {
+			sift_down(0);
+		}
+	}
+
+	// pop followed by push, with a single sift
+	void replace_top(const Key& key) {
+		at(0) = key;
+		sift_down(0);
+	}
+
+	// ordering used by the heap, may be changed as long as it keeps the heap property
+	Compare& comparator() {
+		return compare;
+	}
+
+private:
+	Compare compare;
+	std::vector<Key, AlignedAllocator<Key, OFFSET * sizeof(Key)>> keys;
+
+	Key& at(const std::size_t i) {
+		return keys[i];
+	}
+
+	void sift_up(std::size_t i) {
+		const Key moving = at(i);
+		while (i > 0) {
+			const std::size_t parent = (i - 1) / D;
+			if (!compare(moving, at(parent))) {
+				break;
+			}
+			at(i) = at(parent);
+			i = parent;
+		}
+		at(i) = moving;
+	}
+
+	void sift_down(std::size_t i) {
+		const std::size_t n = size();
+		const Key moving = at(i);
+		while (true) {
+			const std::size_t first = D * i + 1;
+			if (first >= n) {
+				break;
+			}
+			std::size_t best = first;
+			if (first + D <= n) {
+				// all children present: fixed trip count
+				for (std::size_t c = first + 1; c < first + D; c++) {
+					if (compare(at(c), at(best))) best = c;
+				}
+			} else {
+				for (std::size_t c = first + 1; c < n; c++) {
+					if (compare(at(c), at(best))) best = c;
+				}
+			}
+			if (!compare(at(best), moving)) {
+				break;
+			}
+			at(i) = at(best);
+			i = best;
+		}
+		at(i) = moving;
+	}
+};
+
+// key of replacement selection: a value tagged with the parity of the run it belongs to
+// records of the run being written sort before those of the next one
+template<typename T, typename = void>
+struct RunTagged {
+	struct Key {
+		T val;
+		bool tag;
+	};
+
+	static Key make(const T& val, const bool tag) {
+		return Key{val, tag};
+	}
+
+	static const T& value(const Key& key) {
+		return key.val;
+	}
+
+	static bool tag(const Key& key) {
+		return key.tag;
+	}
+
+	struct Less {
+		bool current = false;
+
+		void set_current_run(const bool parity) {
+			current = parity;
+		}
+
+		bool operator()(const Key& a, const Key& b) const {
+			const bool a_next = a.tag != current, b_next = b.tag != current;
+			if (a_next != b_next) {
+				return b_next;
+			}
+			return a.val < b.val;
+		}
+	};
+};
+
+// small integers: the tag is packed above the (order preserving) bits of the value,
+// so comparing two keys is a single integer comparison
+template<typename T>
+struct RunTagged<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) <= 4>> {
+	using Key = std::uint64_t;
+	using Wide = std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>;
+	static constexpr std::uint32_t BIAS = std::is_signed_v<T> ? 0x80000000u : 0u;
+
+	static Key make(const T val, const bool tag) {
+		const std::uint32_t bits = static_cast<std::uint32_t>(static_cast<Wide>(val)) ^ BIAS;
+		return (Key(tag) << 32) | bits;
+	}
+
+	static T value(const Key key) {
+		return static_cast<T>(static_cast<Wide>(static_cast<std::uint32_t>(key) ^ BIAS));
+	}
+
+	static bool tag(const Key key) {
+		return (key >> 32) != 0;
+	}
+
+	struct Less {
+		Key flip = 0;
+
+		void set_current_run(const bool parity) {
+			flip = Key(parity) << 32;
+		}
+
+		bool operator()(const Key a, const Key b) const {
+			return (a ^ flip) < (b ^ flip);
+		}
+	};
+};
+
+#endif //DARY_HEAP_HPP
@@ -0,0 +1,53 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef HYBRID_SORT_HPP
+#define HYBRID_SORT_HPP
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+#include "perf_counters.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+// smallest chunk worth sorting on its own thread in the in-memory path
+constexpr std::size_t MIN_PARALLEL_CHUNK = 1 << 14;
+
+// sorts the records of [first, last), reading them once and holding at most `mem_size` of them:
+// while the input fits in memory it is sorted there by up to `num_threads` threads (of a pool shared
+// by all hybrid sorts, started on first use), without any tape;
+// past that, the buffered records seed run formation and the sort goes on as `method` would
+// (the profiler, if any, sees a single "in-memory" phase, or the phases of the tape sort)
+template<typename InputIt>
+std::vector<typename std::iterator_traits<InputIt>::value_type> hybrid_sort(
+	InputIt first, InputIt last, SortMethod method, std::size_t num_files, std::size_t mem_size,
+	std::size_t num_threads = 1, PhaseProfiler* profiler = nullptr
+);
+
+template<typename T>
+std::vector<T> hybrid_sort(
+	const std::vector<T>& data, SortMethod method, std::size_t num_files, std::size_t mem_size,
+	std::size_t num_threads = 1, PhaseProfiler* profiler = nullptr
+);
+
+// same, with the in-memory path on all the threads of the caller's `pool`
+// (the calling thread joins in, so it may be a task of `pool` itself)
+template<typename InputIt>
+std::vector<typename std::iterator_traits<InputIt>::value_type> hybrid_sort(
+	InputIt first, InputIt last, SortMethod method, std::size_t num_files, std::size_t mem_size,
+	ThreadPool& pool, PhaseProfiler* profiler = nullptr
+);
+
+template<typename T>
+std::vector<T> hybrid_sort(
+	const std::vector<T>& data, SortMethod method, std::size_t num_files, std::size_t mem_size,
+	ThreadPool& pool, PhaseProfiler* profiler = nullptr
+);
+
+// include template implementations
+#include "hybrid_sort.tpp"
+
+#endif //HYBRID_SORT_HPP
@@ -0,0 +1,238 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "balanced_sort.hpp"
+#include "cascade_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "initial_distribution.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+using std::vector;
+
+namespace HybridSortDetail {
+	// runs `tasks` on `pool` and waits for all of them (rethrowing the first exception)
+	// the calling thread claims tasks too, so they all run even if every worker of the pool is busy
+	// (or the caller is one of them)
+	inline void run_all(ThreadPool& pool, vector<std::function<void()>> tasks) {
+		struct Batch {
+			vector<std::function<void()>> tasks;
+			std::atomic<size_t> next{0};
+			std::mutex mutex;
+			std::condition_variable finished;
+			size_t done = 0;
+			std::exception_ptr error;
+		};
+		auto batch = std::make_shared<Batch>();
+		batch->tasks = std::move(tasks);
+		const size_t num_tasks = batch->tasks.size();
+		auto drain = [batch, num_tasks]() {
+			for (size_t i = batch->next.fetch_add(1); i < num_tasks; i = batch->next.fetch_add(1)) {
+				std::exception_ptr error;
+				try {
+					batch->tasks[i]();
+				} catch (...) {
+					error = std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(batch->mutex);
+				if (error && !batch->error) batch->error = error;
+				if (++batch->done == num_tasks) batch->finished.notify_all();
+			}
+		};
+		for (size_t i = 1; i < std::min(num_tasks, pool.size() + 1); i++) {
+			pool.submit(drain);
+		}
+		drain();
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		batch->finished.wait(lock, [&batch, num_tasks]() { return batch->done == num_tasks; });
+		if (batch->error) {
+			std::rethrow_exception(batch->error);
+		}
+	}
+
+	// pool behind hybrid_sort calls that only give a number of threads, created on first use
+	inline ThreadPool& shared_pool() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	// records of `a` among the first k records of the stable merge of a and b
+	template<typename It>
+	size_t co_rank(const size_t k, const It a, const size_t size_a, const It b, const size_t size_b) {
+		size_t low = (k > size_b) ? k - size_b : 0, high = std::min(k, size_a);
+		while (low < high) {
+			const size_t i = low + (high - low) / 2;
+			// a[i] goes before b[k - i - 1] (ties go to a), so more than i records come from a
+			if (!(b[k - i - 1] < a[i])) {
+				low = i + 1;
+			} else {
+				high = i;
+			}
+		}
+		return low;
+	}
+
+	// sorts `data` with up to `num_threads` tasks on `pool` (the shared pool if null): each task sorts a chunk of it, then
+	// neighbouring chunks are merged level by level, between `data` and a scratch buffer of the same size
+	// every merge is split at co-ranks into pieces sized by its share of the data, so each level
+	// (the last one included) runs about `num_threads` equal tasks
+	template<typename T>
+	void parallel_sort(vector<T>& data, const size_t num_threads, ThreadPool* const workers) {
+		const size_t num_chunks = std::min(num_threads, data.size() / MIN_PARALLEL_CHUNK);
+		if (num_chunks <= 1) {
+			std::sort(data.begin(), data.end());
+			return;
+		}
+		ThreadPool& pool = workers ? *workers : shared_pool();
+		// chunk i is [bounds[i], bounds[i + 1])
+		vector<size_t> bounds;
+		for (size_t i = 0; i <= num_chunks; i++) {
+			bounds.emplace_back(data.size() * i / num_chunks);
+		}
+		vector<std::function<void()>> sorts;
+		for (size_t i = 0; i < num_chunks; i++) {
+			sorts.emplace_back([&data, begin = bounds[i], end = bounds[i + 1]]() {
+				std::sort(data.begin() + begin, data.begin() + end);
+			});
+		}
+		run_all(pool, std::move(sorts));
+
+		vector<T> scratch(data.size());
+		vector<T>* from = &data;
+		vector<T>* to = &scratch;
+		while (bounds.size() > 2) {
+			vector<size_t> merged_bounds;
+			vector<std::function<void()>> merges;
+			for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+				const size_t begin = bounds[i];
+				const size_t middle = (i + 2 < bounds.size()) ? bounds[i + 1] : bounds[i + 1];
+				const size_t end = (i + 2 < bounds.size()) ? bounds[i + 2] : bounds[i + 1];
+				merged_bounds.emplace_back(begin);
+				// a chunk without a neighbour is merged with an empty one, i.e. copied
+				const size_t size_a = middle - begin, size_b = end - middle;
+				const size_t pieces = std::max<size_t>(1, num_chunks * (end - begin) / data.size());
+				for (size_t j = 0; j < pieces; j++) {
+					merges.emplace_back([from, to, begin, size_a, size_b, pieces, j]() {
+						const auto a = from->begin() + begin, b = a + size_a;
+						const size_t k_begin = (size_a + size_b) * j / pieces;
+						const size_t k_end = (size_a + size_b) * (j + 1) / pieces;
+						const size_t i_begin = co_rank(k_begin, a, size_a, b, size_b);
+						const size_t i_end = co_rank(k_end, a, size_a, b, size_b);
+						std::merge(
+							a + i_begin, a + i_end, b + (k_begin - i_begin), b + (k_end - i_end),
+							to->begin() + begin + k_begin
+						);
+					});
+				}
+			}
+			merged_bounds.emplace_back(bounds.back());
+			run_all(pool, std::move(merges));
+			bounds = std::move(merged_bounds);
+			std::swap(from, to);
+		}
+		if (from != &data) {
+			data.swap(scratch);
+		}
+	}
+
+	// run formation seeded with `buffered` and the rest of the input, then the merges of `method`
+	template<typename T, typename InputIt>
+	vector<T> tape_sort(
+		vector<T> buffered, InputIt first, InputIt last, const SortMethod method,
+		const size_t num_files, const size_t mem_size, PhaseProfiler* profiler
+	) {
+		// records in the runs of `files` (the input length is only known once it is read)
+		auto num_records = [](const vector<vector<vector<T>>>& files) {
+			size_t n = 0;
+			for (const auto& file: files) {
+				for (const auto& run: file) n += run.size();
+			}
+			return n;
+		};
+		if (method == SortMethod::Balanced) {
+			// same split as balanced_sort
+			vector<vector<vector<T>>> left((num_files + 1) / 2), right(num_files / 2);
+			if (profiler) profiler->begin("runs");
+			perform_initial_distribution(std::move(buffered), first, last, left, mem_size);
+			if (profiler) profiler->end(num_records(left));
+			return _balanced_sort_from_initial(left, right, mem_size, false, profiler).first;
+		}
+		vector<vector<vector<T>>> files(num_files - 1);
+		if (profiler) profiler->begin("runs");
+		perform_initial_distribution(std::move(buffered), first, last, files, mem_size);
+		if (profiler) profiler->end(num_records(files));
+		// add file for merging
+		files.emplace_back();
+		if (method == SortMethod::Polyphasic) {
+			return _polyphasic_sort_from_initial(files, mem_size, false, profiler).first;
+		}
+		return _cascade_sort_from_initial(files, mem_size, false, profiler).first;
+	}
+}
+
+namespace HybridSortDetail {
+	template<typename InputIt>
+	vector<typename std::iterator_traits<InputIt>::value_type> hybrid_sort(
+		InputIt first, InputIt last, const SortMethod method, const size_t num_files, const size_t mem_size,
+		const size_t num_threads, ThreadPool* const pool, PhaseProfiler* profiler
+	) {
+		using T = typename std::iterator_traits<InputIt>::value_type;
+		if (mem_size < 2) {
+			throw std::invalid_argument("mem_size must hold at least 2 records");
+		}
+
+		// buffer up to mem_size records: if the input ends there, it fits in memory
+		vector<T> buffered;
+		for (; first != last && buffered.size() < mem_size; ++first) {
+			buffered.push_back(*first);
+		}
+		if (first == last) {
+			if (profiler) profiler->begin("in-memory");
+			parallel_sort(buffered, num_threads, pool);
+			if (profiler) profiler->end(buffered.size());
+			return buffered;
+		}
+		return tape_sort(std::move(buffered), first, last, method, num_files, mem_size, profiler);
+	}
+}
+
+template<typename InputIt>
+vector<typename std::iterator_traits<InputIt>::value_type> hybrid_sort(
+	InputIt first, InputIt last, const SortMethod method, const size_t num_files, const size_t mem_size,
+	const size_t num_threads, PhaseProfiler* profiler
+) {
+	return HybridSortDetail::hybrid_sort(first, last, method, num_files, mem_size, num_threads, nullptr, profiler);
+}
+
+template<typename InputIt>
+vector<typename std::iterator_traits<InputIt>::value_type> hybrid_sort(
+	InputIt first, InputIt last, const SortMethod method, const size_t num_files, const size_t mem_size,
+	ThreadPool& pool, PhaseProfiler* profiler
+) {
+	return HybridSortDetail::hybrid_sort(first, last, method, num_files, mem_size, pool.size(), &pool, profiler);
+}
+
+template<typename T>
+vector<T> hybrid_sort(
+	const vector<T>& data, const SortMethod method, const size_t num_files, const size_t mem_size,
+	const size_t num_threads, PhaseProfiler* profiler
+) {
+	return hybrid_sort(data.begin(), data.end(), method, num_files, mem_size, num_threads, profiler);
+}
+
+template<typename T>
+vector<T> hybrid_sort(
+	const vector<T>& data, const SortMethod method, const size_t num_files, const size_t mem_size,
+	ThreadPool& pool, PhaseProfiler* profiler
+) {
+	return hybrid_sort(data.begin(), data.end(), method, num_files, mem_size, pool, profiler);
+}
@@ -0,0 +1,81 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef INDEXED_MERGE_SORT_HPP
+#define INDEXED_MERGE_SORT_HPP
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "merge_kernel.hpp"
+
+// records of the input buffer each run being merged gets, by default
+// (so a budget of 2^20 records merges 256 runs at once)
+constexpr std::size_t DEFAULT_BLOCK_SIZE = 4096;
+
+// a tape holding any number of runs back to back, with the offset of every run,
+// so a merge can read many runs of the same tape at once
+template<typename T>
+struct IndexedTape {
+	std::vector<T> records;
+	// run i is records[offsets[i], offsets[i + 1])
+	std::vector<std::size_t> offsets{0};
+
+	std::size_t num_runs() const {
+		return offsets.size() - 1;
+	}
+
+	RunSpan<T> run(const std::size_t i) const {
+		return {records.data() + offsets[i], records.data() + offsets[i + 1]};
+	}
+
+	// closes the run made by the records appended since the last one
+	void end_run() {
+		offsets.push_back(records.size());
+	}
+
+	void clear() {
+		records.clear();
+		offsets.assign(1, 0);
+	}
+};
+
+// runs merged at once when each of them needs a buffer of `block_size` records out of `mem_size`,
+// but never fewer than `min_fan_in` (the fan-in the tapes alone would give) nor than 2,
+// so a small budget falls back to the tape merge instead of losing to it
+std::size_t merge_fan_in(std::size_t mem_size, std::size_t block_size, std::size_t min_fan_in = 2);
+
+// merges every `fan_in` consecutive runs of `input` (read alternating between its tapes)
+// into a single run of `output` (written alternating between its tapes)
+// returns number of writes
+template<typename T>
+std::size_t indexed_merge_pass(
+	const std::vector<IndexedTape<T>>& input, std::vector<IndexedTape<T>>& output, std::size_t fan_in
+);
+
+// merge passes over the initial runs in `left` until a single run is left, using `right` as output
+// returns (sorted_vec, avg writes); avg writes is the number of passes, ceil(log_fan_in(runs))
+template<typename T>
+std::pair<std::vector<T>, double> _indexed_merge_sort_from_initial(
+	std::vector<IndexedTape<T>>& left, std::vector<IndexedTape<T>>& right,
+	std::size_t mem_size, std::size_t fan_in, bool verbose
+);
+
+// balanced merge sort whose fan-in is set by the memory budget instead of the number of files:
+// run formation as in balanced_sort, then each pass merges mem_size / block_size runs at once,
+// taking many of them from the same tape (and at least one run per input tape, as balanced_sort
+// does, so it never makes more passes than balanced_sort)
+// only the balanced schedule uses indexed tapes; polyphasic and cascade sorts keep one run per
+// slot of their tapes
+template<typename T>
+std::vector<T> indexed_merge_sort(
+	std::vector<T> data, std::size_t num_files, std::size_t mem_size,
+	std::size_t block_size = DEFAULT_BLOCK_SIZE, bool verbose = true
+);
+
+// include template implementations
+#include "indexed_merge_sort.tpp"
+
+#endif //INDEXED_MERGE_SORT_HPP
@@ -0,0 +1,157 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "initial_distribution.hpp"
+#include "merge_kernel.hpp"
+#include "utils.hpp"
+
+using std::vector, std::pair;
+
+namespace IndexedMergeSortDetail {
+	template<typename T>
+	size_t num_runs(const vector<IndexedTape<T>>& tapes) {
+		size_t runs = 0;
+		for (const auto& tape: tapes) {
+			runs += tape.num_runs();
+		}
+		return runs;
+	}
+
+	// copy of the tapes as nested runs, for the Observer
+	template<typename T>
+	vector<vector<vector<T>>> unpack(const vector<IndexedTape<T>>& tapes) {
+		vector<vector<vector<T>>> files(tapes.size());
+		for (size_t i = 0; i < tapes.size(); i++) {
+			for (size_t r = 0; r < tapes[i].num_runs(); r++) {
+				const RunSpan<T> run = tapes[i].run(r);
+				files[i].emplace_back(run.begin(), run.end());
+			}
+		}
+		return files;
+	}
+}
+
+inline size_t merge_fan_in(const size_t mem_size, const size_t block_size, const size_t min_fan_in) {
+	if (block_size == 0) {
+		throw std::invalid_argument("block_size must be positive");
+	}
+	return std::max<size_t>({2, min_fan_in, mem_size / block_size});
+}
+
+template<typename T>
+size_t indexed_merge_pass(
+	const vector<IndexedTape<T>>& input, vector<IndexedTape<T>>& output, const size_t fan_in
+) {
+	size_t writes = 0;
+	size_t write_file_idx = 0;
+	size_t max_file_size = 0;
+	for (const auto& tape: input) {
+		max_file_size = std::max(max_file_size, tape.num_runs());
+	}
+
+	vector<RunSpan<T>> runs;
+	runs.reserve(fan_in);
+	auto flush = [&]() {
+		writes += merge_runs(runs, output[write_file_idx].records);
+		output[write_file_idx].end_run();
+		write_file_idx = (write_file_idx + 1) % output.size();
+		runs.clear();
+	};
+	// runs are read in the order they were written: the run_idx-th run of every tape, then the next
+	for (size_t run_idx = 0; run_idx < max_file_size; run_idx++) {
+		for (const auto& tape: input) {
+			if (tape.num_runs() > run_idx) {
+				runs.push_back(tape.run(run_idx));
+				if (runs.size() == fan_in) {
+					flush();
+				}
+			}
+		}
+	}
+	if (!runs.empty()) {
+		flush();
+	}
+	return writes;
+}
+
+template<typename T>
+pair<vector<T>, double> _indexed_merge_sort_from_initial(
+	vector<IndexedTape<T>>& left,
+	vector<IndexedTape<T>>& right,
+	const size_t mem_size,
+	const size_t fan_in,
+	const bool verbose
+){
+	Observer watcher(std::cout);
+	watcher.step = 1;
+
+	size_t n = 0;
+	for (const auto& tape: left) {
+		n += tape.records.size();
+	}
+	size_t writes = 0;
+
+	while (IndexedMergeSortDetail::num_runs(left) > 1) {
+		writes += indexed_merge_pass(left, right, fan_in);
+		for (auto& tape: left) {
+			tape.clear();
+		}
+		std::swap(left, right);
+
+		if (verbose) {
+			watcher.register_step(IndexedMergeSortDetail::unpack(left), mem_size);
+		}
+	}
+	for (const auto& tape: left) {
+		if (tape.num_runs() == 1) {
+			return {tape.records, double(writes) / double(n)};
+		}
+	}
+	// empty input
+	return {vector<T>(), 0.0};
+}
+
+template<typename T>
+vector<T> indexed_merge_sort(
+	const vector<T> data,
+	const size_t num_files,
+	const size_t mem_size,
+	const size_t block_size,
+	const bool verbose
+){
+	Observer watcher(std::cout);
+	// same split as balanced_sort, but any number of runs can go to each tape
+	const size_t left_files = (num_files + 1) / 2, right_files = std::max<size_t>(1, num_files / 2);
+	// balanced_sort merges one run of every left tape at once
+	const size_t fan_in = merge_fan_in(mem_size, block_size, left_files);
+	vector<vector<vector<T>>> files(left_files);
+	perform_initial_distribution(data, files, mem_size);
+	if (verbose) {
+		watcher.register_step(files, mem_size);
+	}
+
+	vector<IndexedTape<T>> left(left_files), right(right_files);
+	for (size_t i = 0; i < left_files; i++) {
+		for (auto& run: files[i]) {
+			left[i].records.insert(left[i].records.end(), run.begin(), run.end());
+			left[i].end_run();
+			run = vector<T>();
+		}
+	}
+
+	auto[sorted_data, avg_writes] = _indexed_merge_sort_from_initial(
+		left, right, mem_size, fan_in, verbose
+	);
+	if (verbose){
+		std::cout << "final " << std::fixed << std::setprecision(2) << avg_writes << std::endl;
+	}
+	return sorted_data;
+}
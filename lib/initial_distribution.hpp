@@ -7,12 +7,23 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstddef>
 
 template<typename T>
 void perform_initial_distribution(
 	std::vector<T> data,
 	std::vector<std::vector<std::vector<T>>> &main_files,
-	int mem_size
+	std::size_t mem_size
+);
+
+// same as above, for records that are already partly read: `buffered` (at most mem_size records
+// held in memory) seeds the selection heap, and the rest of the input is read once from [first, last)
+template<typename T, typename InputIt>
+void perform_initial_distribution(
+	std::vector<T> buffered,
+	InputIt first, InputIt last,
+	std::vector<std::vector<std::vector<T>>> &main_files,
+	std::size_t mem_size
 );
 
 // include template implementations
@@ -3,72 +3,102 @@
 #include <vector>
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <type_traits>
+#include "dary_heap.hpp"
 #include "utils.hpp"
 
 using std::vector;
 
-// do initial distribution of records
-template<typename T>
+// do initial distribution of records, the first ones already buffered in memory
+template<typename T, typename InputIt>
 void perform_initial_distribution(
-	vector<T> data,
+	vector<T> buffered,
+	InputIt first, InputIt last,
 	vector<vector<vector<T>>> &main_files,
-	const int mem_size
+	const size_t mem_size
 ) {
 	assert(mem_size > 1);
+	assert(buffered.size() <= mem_size);
 
-	// special heap of marked values
-	min_priority_queue<MarkedValue<T>> min_heap;
+	// heap of values tagged with the parity of their run
+	// (values that would break the order of the current run go to the next one)
+	using Tagged = RunTagged<T>;
+	DaryHeap<typename Tagged::Key, typename Tagged::Less> min_heap;
+	size_t capacity = mem_size;
+	if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+		capacity = std::min(mem_size, buffered.size() + size_t(std::distance(first, last)));
+	}
+	min_heap.reserve(capacity);
+	bool parity = false;  // parity of the run being written
 	vector<T> current_run;
-	int file_idx = 0, marked_cnt = 0;
-	const int p = main_files.size();
+	size_t file_idx = 0;
+	const size_t p = main_files.size();
 
-	for (int i = 0; i < data.size(); i++){
-		const T& x = data[i];
-		if (i < mem_size){
-            min_heap.emplace(x);
-            continue;
-		}
+	// fill memory, starting from the records already buffered
+	for (const T& x: buffered) {
+		min_heap.push(Tagged::make(x, parity));
+	}
+	buffered = vector<T>();
+	for (; first != last && min_heap.size() < mem_size; ++first) {
+		min_heap.push(Tagged::make(*first, parity));
+	}
+
+	for (; first != last; ++first){
+		const T x = *first;
 
-        if (marked_cnt == mem_size) {
-            // that means all values are marked, so unmark and start a new run
-        	main_files[file_idx].emplace_back(current_run);
+        if (Tagged::tag(min_heap.top()) != parity) {
+            // that means all values belong to the next run, so start it
+        	main_files[file_idx].emplace_back(std::move(current_run));
         	current_run = vector<T>();
             file_idx = (file_idx + 1) % p;
-            unmark_all(min_heap);
-        	marked_cnt = 0;
+        	parity = !parity;
+        	min_heap.comparator().set_current_run(parity);
         }
-		// make room for new data (removing 1 from heap)
-        MarkedValue<T> min_key = min_heap.top();
-        T curr_value = min_key.val;
-        current_run.push_back(curr_value);
-        min_heap.pop();
-		// push new data (1 entry)
-		if (x < current_run.back()) {  // breaks order (smaller and comes after) -> push marked
-			min_heap.emplace(x, true);
-			++marked_cnt;
+		// make room for new data (replacing the minimum by it)
+		current_run.push_back(Tagged::value(min_heap.top()));
+		// breaks order (smaller and comes after) -> goes to the next run
+		const bool tag = (x < current_run.back()) ? !parity : parity;
+		min_heap.replace_top(Tagged::make(x, tag));
+	}
+
+	// split leftover data between current and next run (each in order)
+	vector<T> current_leftover, next_leftover;
+	while (!min_heap.empty()) {
+		const auto key = min_heap.top();
+		min_heap.pop();
+		if (Tagged::tag(key) == parity) {
+			current_leftover.push_back(Tagged::value(key));
 		} else {
-			min_heap.emplace(x, false);
+			next_leftover.push_back(Tagged::value(key));
 		}
 	}
-
-	// unmark leftover data
-	// and reset current run (can't mix with marked data without breaking order)
-	if (marked_cnt > 0) {
-		main_files[file_idx].emplace_back(current_run);
+	if (!next_leftover.empty()) {
+		// reset current run (can't mix with data of the next run without breaking order)
+		// and put all leftover data in a last run
+		main_files[file_idx].emplace_back(std::move(current_run));
 		current_run = vector<T>();
 		file_idx = (file_idx + 1) % p;
-		unmark_all(min_heap);
-		marked_cnt = 0;
-	}
-	// distribute leftover data
-	while (!min_heap.empty()) {
-		MarkedValue<T> min_key = min_heap.top();
-		min_heap.pop();
-		current_run.push_back(T(min_key));
+		std::merge(
+			current_leftover.begin(), current_leftover.end(),
+			next_leftover.begin(), next_leftover.end(),
+			std::back_inserter(current_run)
+		);
+	} else {
+		current_run.insert(current_run.end(), current_leftover.begin(), current_leftover.end());
 	}
 	if (!current_run.empty()) {
 		// register last run
-		main_files[file_idx].emplace_back(current_run);
+		main_files[file_idx].emplace_back(std::move(current_run));
 	}
 }
 
+// do initial distribution of records
+template<typename T>
+void perform_initial_distribution(
+	vector<T> data,
+	vector<vector<vector<T>>> &main_files,
+	const size_t mem_size
+) {
+	perform_initial_distribution(vector<T>(), data.begin(), data.end(), main_files, mem_size);
+}
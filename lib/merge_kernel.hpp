@@ -0,0 +1,67 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef MERGE_KERNEL_HPP
+#define MERGE_KERNEL_HPP
+
+#include <vector>
+#include <cstddef>
+
+// largest fan-in with a compile-time specialized merge, larger ones use the heap
+// (up to 16 runs the tournament beats the heap on random, interleaved and presorted runs alike
+// in scripts/benchmark_merge.cpp: the tree replays one match per level for each record, while
+// the heap sifts a record down to a leaf and the next head up again)
+constexpr std::size_t MAX_FIXED_FAN_IN = 16;
+
+// after the same run wins this many times in a row, the merge gallops:
+// it searches how far that run stays ahead of the next best head and copies that range in bulk
+// (in the loser tree the runner-up is found on the winner's path and the tree is replayed once per
+// gallop, not once per copied record; see the presorted and streaks cases of scripts/benchmark_merge.cpp)
+constexpr std::size_t MIN_GALLOP = 7;
+
+// a sorted run stored anywhere in memory, as the range [first, last)
+// (e.g. one of the many runs kept back to back in a single tape)
+template<typename T>
+struct RunSpan {
+	const T* first;
+	const T* last;
+
+	const T* data() const { return first; }
+	const T* begin() const { return first; }
+	const T* end() const { return last; }
+	std::size_t size() const { return last - first; }
+	bool empty() const { return first == last; }
+	const T& operator[](const std::size_t i) const { return first[i]; }
+};
+
+// merges the sorted runs pointed by `runs`, appending the result to `out`
+// on equal values, the run that comes first in `runs` wins
+// long stretches won by a single run (e.g. in presorted data) are copied in bulk
+// returns number of writes
+template<typename T>
+std::size_t merge_runs(const std::vector<const std::vector<T>*>& runs, std::vector<T>& out);
+
+template<typename T>
+std::size_t merge_runs(const std::vector<RunSpan<T>>& runs, std::vector<T>& out);
+
+// fan-in K merge with a tournament (loser) tree whose size is known at compile time
+// matches are decided without branches (their outcome is a coin flip on random data), and once a run
+// is exhausted the others go on with the K - 1 merge, so the tree never checks for the end of a run
+template<std::size_t K, typename T>
+std::size_t merge_runs_fixed(const std::vector<const std::vector<T>*>& runs, std::vector<T>& out);
+
+template<std::size_t K, typename T>
+std::size_t merge_runs_fixed(const std::vector<RunSpan<T>>& runs, std::vector<T>& out);
+
+// generic merge with a binary heap, for any fan-in
+template<typename T>
+std::size_t merge_runs_generic(const std::vector<const std::vector<T>*>& runs, std::vector<T>& out);
+
+template<typename T>
+std::size_t merge_runs_generic(const std::vector<RunSpan<T>>& runs, std::vector<T>& out);
+
+// include template implementations
+#include "merge_kernel.tpp"
+
+#endif //MERGE_KERNEL_HPP
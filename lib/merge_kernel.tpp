@@ -0,0 +1,238 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "utils.hpp"
+
+using std::vector, std::pair;
+
+namespace MergeKernelDetail {
+	// length of the prefix of [first, last) that is output before `bound`
+	// (smaller values, and equal ones too when the run wins ties), by exponential search
+	template<typename T>
+	size_t gallop(const T* first, const T* last, const T& bound, const bool wins_ties) {
+		auto precedes = [&bound, wins_ties](const T& x) {
+			return wins_ties ? !(bound < x) : x < bound;
+		};
+		const size_t n = last - first;
+		// first[0..found) precede bound, first[found + step - 1] (if any) does not
+		size_t found = 0, step = 1;
+		while (found + step <= n && precedes(first[found + step - 1])) {
+			found += step;
+			step <<= 1;
+		}
+		const T* limit = first + std::min(found + step - 1, n);
+		return std::partition_point(first + found, limit, precedes) - first;
+	}
+
+	// a run in the loser tree with its head, so a match needs no lookup through the cursors:
+	// small trivially copyable heads are cached by value, others are read through a pointer
+	template<typename T, typename = void>
+	struct TreeEntry {
+		const T* head;
+		size_t run;
+
+		const T& key() const { return *head; }
+		void set_head(const T* cursor) { head = cursor; }
+	};
+
+	template<typename T>
+	struct TreeEntry<T, std::enable_if_t<
+		std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && sizeof(T) <= sizeof(void*)
+	>> {
+		T head;
+		size_t run;
+
+		const T& key() const { return head; }
+		void set_head(const T* cursor) { head = *cursor; }
+	};
+
+	template<typename T>
+	vector<RunSpan<T>> spans(const vector<const vector<T>*>& runs) {
+		vector<RunSpan<T>> result;
+		result.reserve(runs.size());
+		for (const vector<T>* run: runs) {
+			result.push_back({run->data(), run->data() + run->size()});
+		}
+		return result;
+	}
+
+	template<size_t K, typename T>
+	size_t dispatch(const vector<RunSpan<T>>& runs, vector<T>& out) {
+		if constexpr (K > MAX_FIXED_FAN_IN) {
+			return merge_runs_generic(runs, out);
+		} else {
+			if (runs.size() == K) {
+				return merge_runs_fixed<K>(runs, out);
+			}
+			return dispatch<K + 1>(runs, out);
+		}
+	}
+}
+
+template<size_t K, typename T>
+size_t merge_runs_fixed(const vector<RunSpan<T>>& runs, vector<T>& out) {
+	static_assert(K >= 2, "a fixed merge needs at least 2 runs");
+	// cursor of each run: its next record is the head of the run
+	std::array<const T*, K> next{}, end{};
+	size_t total = 0;
+	for (size_t i = 0; i < K; i++) {
+		next[i] = runs[i].data();
+		end[i] = runs[i].data() + runs[i].size();
+		total += runs[i].size();
+	}
+	// runs left once one of them is exhausted, merged with one fewer leaf (and no end checks in the tree)
+	auto merge_rest = [&next, &end, &out, total]() {
+		vector<RunSpan<T>> rest;
+		for (size_t i = 0; i < K; i++) {
+			if (next[i] != end[i]) {
+				rest.push_back({next[i], end[i]});
+			}
+		}
+		if (!rest.empty()) {
+			merge_runs(rest, out);
+		}
+		return total;
+	};
+	for (size_t i = 0; i < K; i++) {
+		if (next[i] == end[i]) {
+			return merge_rest();
+		}
+	}
+	using Entry = MergeKernelDetail::TreeEntry<T>;
+	// true if a should be output before b (ties go to the smaller run)
+	auto beats = [](const Entry& a, const Entry& b) {
+		const T& x = a.key();
+		const T& y = b.key();
+		return bool((x < y) | ((a.run < b.run) & !(y < x)));
+	};
+
+	// leaf i is node K + i, so any K works without padding leaves;
+	// tree[1..K-1] hold the run that lost each match, built from the winners bottom-up
+	std::array<Entry, 2 * K> winners{};
+	std::array<Entry, K> tree{};
+	for (size_t i = 0; i < K; i++) {
+		winners[K + i].set_head(next[i]);
+		winners[K + i].run = i;
+	}
+	for (size_t node = K - 1; node >= 1; node--) {
+		const Entry& left = winners[2 * node];
+		const Entry& right = winners[2 * node + 1];
+		if (beats(left, right)) {
+			winners[node] = left;
+			tree[node] = right;
+		} else {
+			winners[node] = right;
+			tree[node] = left;
+		}
+	}
+	Entry winner = winners[1];
+
+	out.reserve(out.size() + total);
+	size_t streak = 0, last_leaf = K;
+	while (true) {
+		const size_t leaf = winner.run;
+		streak = (leaf == last_leaf) ? streak + 1 : 1;
+		last_leaf = leaf;
+		out.push_back(*next[leaf]);
+		++next[leaf];
+		if (streak >= MIN_GALLOP && next[leaf] != end[leaf]) {
+			// the runner-up is the best of the runs that lost to the winner on its way up
+			size_t node = (leaf + K) >> 1;
+			Entry runner_up = tree[node];
+			for (node >>= 1; node >= 1; node >>= 1) {
+				if (beats(tree[node], runner_up)) {
+					runner_up = tree[node];
+				}
+			}
+			// copy in bulk everything in this run that still comes before the runner-up
+			const size_t count = MergeKernelDetail::gallop(next[leaf], end[leaf], runner_up.key(), leaf < runner_up.run);
+			out.insert(out.end(), next[leaf], next[leaf] + count);
+			next[leaf] += count;
+			streak = 0;
+		}
+		if (next[leaf] == end[leaf]) {
+			return merge_rest();
+		}
+		// replay the matches from the winner's leaf up to the root
+		winner.set_head(next[leaf]);
+		for (size_t node = (leaf + K) >> 1; node >= 1; node >>= 1) {
+			// select instead of branching: the outcome of a match is unpredictable on random data
+			const Entry other = tree[node];
+			const bool lost = beats(other, winner);
+			tree[node] = lost ? winner : other;
+			winner = lost ? other : winner;
+		}
+	}
+}
+
+template<typename T>
+size_t merge_runs_generic(const vector<RunSpan<T>>& runs, vector<T>& out) {
+	// min heap of pair (value, run index)
+	min_priority_queue<pair<T, size_t>> min_heap;
+	vector<size_t> ptrs(runs.size(), 0);
+	size_t total = 0;
+	for (size_t i = 0; i < runs.size(); i++) {
+		total += runs[i].size();
+		if (!runs[i].empty()) {
+			min_heap.emplace(runs[i][0], i);
+			++ptrs[i];
+		}
+	}
+
+	out.reserve(out.size() + total);
+	size_t streak = 0, last_run = runs.size();
+	while (!min_heap.empty()) {
+		auto[value, i] = min_heap.top();
+		min_heap.pop();
+		out.emplace_back(value);
+		streak = (i == last_run) ? streak + 1 : 1;
+		last_run = i;
+		if (streak >= MIN_GALLOP) {
+			// copy in bulk everything in this run that still comes before the next best head
+			const T* first = runs[i].data() + ptrs[i];
+			const T* last = runs[i].data() + runs[i].size();
+			const size_t count = min_heap.empty()
+				? size_t(last - first)
+				: MergeKernelDetail::gallop(first, last, min_heap.top().first, i < min_heap.top().second);
+			out.insert(out.end(), first, first + count);
+			ptrs[i] += count;
+		}
+		if (ptrs[i] < runs[i].size()) {
+			min_heap.emplace(runs[i][ptrs[i]], i);
+			++ptrs[i];
+		}
+	}
+	return total;
+}
+
+template<typename T>
+size_t merge_runs(const vector<RunSpan<T>>& runs, vector<T>& out) {
+	if (runs.size() == 1) {
+		out.insert(out.end(), runs[0].begin(), runs[0].end());
+		return runs[0].size();
+	}
+	return MergeKernelDetail::dispatch<2>(runs, out);
+}
+
+template<size_t K, typename T>
+size_t merge_runs_fixed(const vector<const vector<T>*>& runs, vector<T>& out) {
+	return merge_runs_fixed<K>(MergeKernelDetail::spans(runs), out);
+}
+
+template<typename T>
+size_t merge_runs_generic(const vector<const vector<T>*>& runs, vector<T>& out) {
+	return merge_runs_generic(MergeKernelDetail::spans(runs), out);
+}
+
+template<typename T>
+size_t merge_runs(const vector<const vector<T>*>& runs, vector<T>& out) {
+	return merge_runs(MergeKernelDetail::spans(runs), out);
+}
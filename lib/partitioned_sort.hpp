@@ -0,0 +1,48 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef PARTITIONED_SORT_HPP
+#define PARTITIONED_SORT_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "utils.hpp"
+
+// picks `num_parts - 1` splitters from a sorted random sample of `oversampling` records per part
+// records x with splitters[i - 1] <= x < splitters[i] belong to part i
+template<typename T>
+std::vector<T> choose_splitters(const std::vector<T>& data, std::size_t num_parts, std::size_t oversampling = 32);
+
+// bounds on the num_files of a sort request
+constexpr std::size_t MIN_REQUEST_FILES = 3;
+constexpr std::size_t MAX_REQUEST_FILES = 1024;
+// default bound on the records of a sort request (4 GiB of them)
+constexpr std::size_t MAX_REQUEST_BYTES = std::size_t(1) << 32;
+
+// answers a single sort request on the connected socket `fd`:
+// reads the method, the sort parameters and the records, and writes back the sorted records
+// the header and the records travel in host byte order and layout, so the peer must run on the same
+// host with the same T, like the socketpair of partitioned_sort; it is not a network protocol
+// the header is still validated before anything is allocated: throws std::invalid_argument for an
+// unknown method, num_files outside [MIN_REQUEST_FILES, MAX_REQUEST_FILES], mem_size < 2
+// or more than `max_records` records
+template<typename T>
+void serve_sort_request(int fd, std::size_t max_records = MAX_REQUEST_BYTES / sizeof(T));
+
+// sample sort over worker processes: the records are split into `num_workers` key ranges,
+// each range is sorted by a forked worker (reached through a Unix socket) with `method`,
+// and the sorted ranges are concatenated (no final merge is needed)
+// POSIX only; the calling process should not have other threads running, since it forks
+// throws std::invalid_argument for parameters a worker would reject (see serve_sort_request)
+template<typename T>
+std::vector<T> partitioned_sort(
+	std::vector<T> data, SortMethod method, std::size_t num_workers,
+	std::size_t num_files, std::size_t mem_size, std::size_t oversampling = 32
+);
+
+// include template implementations
+#include "partitioned_sort.tpp"
+
+#endif //PARTITIONED_SORT_HPP
@@ -0,0 +1,274 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "balanced_sort.hpp"
+#include "cascade_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "utils.hpp"
+
+using std::vector;
+
+namespace PartitionDetail {
+	// header of a sort request, followed by `count` records; all fields are
+	// 64-bit so the struct has no padding bytes to leak onto the socket
+	struct RequestHeader {
+		std::uint64_t method;
+		std::uint64_t num_files;
+		std::uint64_t mem_size;
+		std::uint64_t count;
+	};
+	static_assert(sizeof(RequestHeader) == 4 * sizeof(std::uint64_t), "RequestHeader must not have padding");
+
+	inline std::runtime_error system_error(const std::string& what) {
+		return std::runtime_error(what + ": " + std::strerror(errno));
+	}
+
+	inline void send_all(const int fd, const void* buffer, size_t size) {
+		const char* ptr = static_cast<const char*>(buffer);
+		while (size > 0) {
+			const ssize_t sent = send(fd, ptr, size, MSG_NOSIGNAL);
+			if (sent < 0) {
+				if (errno == EINTR) continue;
+				throw system_error("send failed");
+			}
+			ptr += sent;
+			size -= sent;
+		}
+	}
+
+	inline void recv_all(const int fd, void* buffer, size_t size) {
+		char* ptr = static_cast<char*>(buffer);
+		while (size > 0) {
+			const ssize_t received = recv(fd, ptr, size, 0);
+			if (received < 0) {
+				if (errno == EINTR) continue;
+				throw system_error("recv failed");
+			}
+			if (received == 0) {
+				throw std::runtime_error("connection closed before the whole message arrived");
+			}
+			ptr += received;
+			size -= received;
+		}
+	}
+
+	template<typename T>
+	void send_records(const int fd, const vector<T>& records) {
+		const std::uint64_t count = records.size();
+		send_all(fd, &count, sizeof(count));
+		send_all(fd, records.data(), records.size() * sizeof(T));
+	}
+
+	// the peer's answer must hold exactly the `expected` records it was sent
+	template<typename T>
+	vector<T> recv_records(const int fd, const size_t expected) {
+		std::uint64_t count;
+		recv_all(fd, &count, sizeof(count));
+		if (count != expected) {
+			throw std::runtime_error(
+				"expected " + std::to_string(expected) + " sorted records, the worker announced " + std::to_string(count)
+			);
+		}
+		vector<T> records(count);
+		recv_all(fd, records.data(), count * sizeof(T));
+		return records;
+	}
+
+	template<typename T>
+	vector<T> sort_with(const SortMethod method, const vector<T>& data, const size_t num_files, const size_t mem_size) {
+		if (data.empty()) {
+			return data;
+		}
+		switch (method) {
+			case SortMethod::Balanced:
+				return balanced_sort(data, num_files, mem_size, false);
+			case SortMethod::Polyphasic:
+				return polyphasic_sort(data, num_files, mem_size, false);
+			case SortMethod::Cascade:
+				return cascade_sort(data, num_files, mem_size, false);
+		}
+		throw std::invalid_argument("invalid sorting method");
+	}
+
+	// rejects sort parameters no method can run with, before anything is allocated for them
+	inline void check_request(
+		const std::uint64_t method, const std::uint64_t num_files, const std::uint64_t mem_size,
+		const std::uint64_t count, const size_t max_records
+	) {
+		if (method > static_cast<std::uint64_t>(SortMethod::Cascade)) {
+			throw std::invalid_argument("invalid sorting method " + std::to_string(method));
+		}
+		if (num_files < MIN_REQUEST_FILES || num_files > MAX_REQUEST_FILES) {
+			throw std::invalid_argument(
+				"num_files must be between " + std::to_string(MIN_REQUEST_FILES) + " and "
+				+ std::to_string(MAX_REQUEST_FILES) + ", got " + std::to_string(num_files)
+			);
+		}
+		if (mem_size < 2) {
+			throw std::invalid_argument("mem_size must hold at least 2 records, got " + std::to_string(mem_size));
+		}
+		if (count > max_records) {
+			throw std::invalid_argument(
+				"sort request of " + std::to_string(count) + " records exceeds the limit of " + std::to_string(max_records)
+			);
+		}
+	}
+}
+
+template<typename T>
+vector<T> choose_splitters(const vector<T>& data, const size_t num_parts, const size_t oversampling) {
+	if (num_parts <= 1 || data.empty()) {
+		return {};
+	}
+	// fixed seed, so the partition of a given input is reproducible
+	std::mt19937_64 rng(data.size());
+	std::uniform_int_distribution<size_t> position(0, data.size() - 1);
+	vector<T> sample(num_parts * oversampling);
+	for (T& x: sample) {
+		x = data[position(rng)];
+	}
+	std::sort(sample.begin(), sample.end());
+
+	vector<T> splitters;
+	for (size_t i = 1; i < num_parts; i++) {
+		splitters.emplace_back(sample[i * oversampling]);
+	}
+	return splitters;
+}
+
+template<typename T>
+void serve_sort_request(const int fd, const size_t max_records) {
+	static_assert(std::is_trivially_copyable_v<T>, "records are sent as raw bytes");
+	PartitionDetail::RequestHeader header{};
+	PartitionDetail::recv_all(fd, &header, sizeof(header));
+	PartitionDetail::check_request(header.method, header.num_files, header.mem_size, header.count, max_records);
+	vector<T> data(header.count);
+	PartitionDetail::recv_all(fd, data.data(), header.count * sizeof(T));
+
+	const vector<T> sorted_data = PartitionDetail::sort_with(
+		static_cast<SortMethod>(header.method), data, header.num_files, header.mem_size
+	);
+	PartitionDetail::send_records(fd, sorted_data);
+}
+
+template<typename T>
+vector<T> partitioned_sort(
+	vector<T> data,
+	const SortMethod method,
+	const size_t num_workers,
+	const size_t num_files,
+	const size_t mem_size,
+	const size_t oversampling
+) {
+	static_assert(std::is_trivially_copyable_v<T>, "records are sent as raw bytes");
+	if (num_workers == 0) {
+		throw std::invalid_argument("partitioned_sort needs at least one worker");
+	}
+	// the workers would reject these, but the caller gets a clearer error from here
+	PartitionDetail::check_request(static_cast<std::uint64_t>(method), num_files, mem_size, 0, 0);
+
+	// split the records into key ranges
+	const vector<T> splitters = choose_splitters(data, num_workers, oversampling);
+	vector<vector<T>> parts(num_workers);
+	for (const T& x: data) {
+		parts[std::upper_bound(splitters.begin(), splitters.end(), x) - splitters.begin()].emplace_back(x);
+	}
+	data = vector<T>();
+
+	// start one worker per key range
+	vector<int> sockets;
+	vector<pid_t> workers;
+	auto cleanup = [&sockets, &workers]() {
+		for (const int fd: sockets) close(fd);
+		for (const pid_t pid: workers) waitpid(pid, nullptr, 0);
+	};
+	for (size_t i = 0; i < num_workers; i++) {
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+			const auto error = PartitionDetail::system_error("socketpair failed");
+			cleanup();
+			throw error;
+		}
+		const pid_t pid = fork();
+		if (pid < 0) {
+			const auto error = PartitionDetail::system_error("fork failed");
+			close(fds[0]);
+			close(fds[1]);
+			cleanup();
+			throw error;
+		}
+		if (pid == 0) {
+			// worker: only keeps its own end of its own socket
+			for (const int fd: sockets) close(fd);
+			close(fds[0]);
+			int status = 0;
+			try {
+				// a worker accepts no more than the range it was forked for
+				serve_sort_request<T>(fds[1], parts[i].size());
+			} catch (...) {
+				status = 1;
+			}
+			close(fds[1]);
+			_exit(status);
+		}
+		close(fds[1]);
+		sockets.emplace_back(fds[0]);
+		workers.emplace_back(pid);
+	}
+
+	vector<size_t> expected_sizes;
+	for (const vector<T>& part: parts) {
+		expected_sizes.emplace_back(part.size());
+	}
+	vector<T> sorted_data;
+	try {
+		// workers read their whole range before answering, so sending everything first cannot deadlock
+		for (size_t i = 0; i < num_workers; i++) {
+			const PartitionDetail::RequestHeader header{
+				static_cast<std::uint64_t>(method), num_files, mem_size, parts[i].size()
+			};
+			PartitionDetail::send_all(sockets[i], &header, sizeof(header));
+			PartitionDetail::send_all(sockets[i], parts[i].data(), parts[i].size() * sizeof(T));
+			parts[i] = vector<T>();
+		}
+		// ranges are disjoint and in order, so concatenating them sorts the data
+		for (size_t i = 0; i < num_workers; i++) {
+			const vector<T> part = PartitionDetail::recv_records<T>(sockets[i], expected_sizes[i]);
+			sorted_data.insert(sorted_data.end(), part.begin(), part.end());
+		}
+	} catch (...) {
+		cleanup();
+		throw;
+	}
+
+	for (const int fd: sockets) close(fd);
+	sockets.clear();
+	bool failed = false;
+	for (const pid_t pid: workers) {
+		int status = 0;
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			failed = true;
+		}
+	}
+	if (failed) {
+		throw std::runtime_error("a sort worker exited with an error");
+	}
+	return sorted_data;
+}
@@ -0,0 +1,195 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <vector>
+#include <array>
+#include <string>
+#include <optional>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// hardware counters read around each phase (std::nullopt when a counter could not be opened)
+struct CounterValues {
+	std::optional<std::uint64_t> cycles, instructions, llc_misses, branch_misses;
+};
+
+// cycles, instructions, LLC misses and branch misses of the calling thread, via perf_event_open
+// the counters are opened as one group, so they always cover the same instructions, and are
+// scaled by time_enabled / time_running when the kernel multiplexes them with other events
+// counters that are unavailable (no permission, virtual machine, other OS) are simply skipped
+class PerfCounters {
+public:
+	PerfCounters() {
+#ifdef __linux__
+		const std::array<std::pair<std::uint32_t, std::uint64_t>, NUM_COUNTERS> events = {{
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+			{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+		}};
+		// the first counter that opens leads the group, the others join it or are skipped
+		for (std::size_t i = 0; i < NUM_COUNTERS; i++) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = events[i].first;
+			attr.config = events[i].second;
+			attr.disabled = leader() < 0 ? 1 : 0;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader(), 0));
+			if (fd >= 0) {
+				fds[i] = fd;
+				order[num_open++] = i;
+			}
+		}
+#endif
+	}
+
+	~PerfCounters() {
+#ifdef __linux__
+		for (const int fd: fds) {
+			if (fd >= 0) close(fd);
+		}
+#endif
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	// true if at least one counter could be opened
+	bool available() const {
+		return num_open > 0;
+	}
+
+	void start() {
+#ifdef __linux__
+		if (!available()) return;
+		ioctl(leader(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+	}
+
+	CounterValues stop() {
+		std::array<std::optional<std::uint64_t>, NUM_COUNTERS> values;
+#ifdef __linux__
+		if (available()) {
+			ioctl(leader(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+			// group read: nr, time_enabled, time_running, then one value per member in the order they joined
+			std::array<std::uint64_t, 3 + NUM_COUNTERS> buffer{};
+			const ssize_t expected = static_cast<ssize_t>((3 + num_open) * sizeof(std::uint64_t));
+			if (read(leader(), buffer.data(), sizeof(buffer)) == expected && buffer[0] == num_open && buffer[2] > 0) {
+				for (std::size_t j = 0; j < num_open; j++) {
+					values[order[j]] = scale(buffer[3 + j], buffer[1], buffer[2]);
+				}
+			}
+		}
+#endif
+		return {values[0], values[1], values[2], values[3]};
+	}
+
+private:
+	static constexpr std::size_t NUM_COUNTERS = 4;
+	std::array<int, NUM_COUNTERS> fds{-1, -1, -1, -1};
+	// counters in the order they joined the group (the first one is the leader)
+	std::array<std::size_t, NUM_COUNTERS> order{};
+	std::size_t num_open = 0;
+
+	int leader() const {
+		return num_open > 0 ? fds[order[0]] : -1;
+	}
+
+	// estimate of the full count when the group was only scheduled for part of the time
+	static std::uint64_t scale(const std::uint64_t value, const std::uint64_t enabled, const std::uint64_t running) {
+		if (enabled == running) return value;
+		return static_cast<std::uint64_t>(double(value) * double(enabled) / double(running));
+	}
+};
+
+// counters of one phase of a sort, and the records written in it
+struct PhaseProfile {
+	std::string name;
+	std::size_t records = 0;
+	CounterValues counters;
+
+	std::optional<double> ipc() const {
+		if (!counters.cycles || !counters.instructions || *counters.cycles == 0) return std::nullopt;
+		return double(*counters.instructions) / double(*counters.cycles);
+	}
+
+	std::optional<double> llc_misses_per_record() const {
+		return per_record(counters.llc_misses);
+	}
+
+	std::optional<double> branch_misses_per_record() const {
+		return per_record(counters.branch_misses);
+	}
+
+private:
+	std::optional<double> per_record(const std::optional<std::uint64_t>& count) const {
+		if (!count || records == 0) return std::nullopt;
+		return double(*count) / double(records);
+	}
+};
+
+// collects a PhaseProfile for run formation and for every merge phase of a sort
+// (pass it to balanced_sort / polyphasic_sort / cascade_sort or their _from_initial versions)
+class PhaseProfiler {
+public:
+	bool available() const {
+		return counters.available();
+	}
+
+	void begin(const std::string& name) {
+		current = name;
+		counters.start();
+	}
+
+	void end(const std::size_t records) {
+		profiles.push_back({current, records, counters.stop()});
+	}
+
+	const std::vector<PhaseProfile>& phases() const {
+		return profiles;
+	}
+
+	void report(std::ostream& os) const {
+		auto print = [&os](const char* label, const std::optional<double>& value) {
+			os << " " << label << " ";
+			if (value) {
+				os << std::fixed << std::setprecision(2) << *value;
+			} else {
+				os << "n/a";
+			}
+		};
+		for (const PhaseProfile& phase: profiles) {
+			os << phase.name << ":";
+			print("ipc", phase.ipc());
+			print("llc-misses/record", phase.llc_misses_per_record());
+			print("branch-misses/record", phase.branch_misses_per_record());
+			os << std::endl;
+		}
+	}
+
+private:
+	PerfCounters counters;
+	std::string current;
+	std::vector<PhaseProfile> profiles;
+};
+
+#endif //PERF_COUNTERS_HPP
@@ -6,9 +6,16 @@
 #define POLYPHASIC_SORT_HPP
 
 #include <vector>
+#include <cstddef>
 
+#include "checkpoint.hpp"
+#include "perf_counters.hpp"
+
+// checkpoint (optional): saved at every phase boundary, at the price of writing all the records
+// once more per phase (see Checkpoint)
 template<typename T>
-std::vector<T> polyphasic_sort(std::vector<T> data, int num_files, int mem_size, bool verbose = true);
+std::vector<T> polyphasic_sort(std::vector<T> data, std::size_t num_files, std::size_t mem_size, bool verbose = true,
+	PhaseProfiler* profiler = nullptr, Checkpoint* checkpoint = nullptr);
 
 // include template implementations
 #include "polyphasic_sort.tpp"
@@ -5,34 +5,75 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <limits>
 
 #include "initial_distribution.hpp"
 #include "cascade_sort.hpp"
+#include "checkpoint.hpp"
+#include "perf_counters.hpp"
 #include "utils.hpp"
 
 using std::pair, std::min;
 
+// single polyphase step: merge runs from every non-empty tape into the first empty one
+// until some tape runs out, then redistribute if a single tape is left
+// works both on tapes of runs and on count-only tapes (RunLengthTape)
+// returns number of writes
+template<typename Tape>
+size_t polyphase_step(
+	vector<Tape>& main_files,
+	const size_t mem_size
+) {
+	constexpr size_t INF = std::numeric_limits<size_t>::max();
+	constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+	// find minimum of runs on non-empty, and first empty file
+	size_t num_steps = INF, idx = NONE;
+	vector<size_t> merge_ids;
+	for (size_t i = 0; i < main_files.size(); i++) {
+		if (!main_files[i].empty()) {
+			num_steps = min(num_steps, main_files[i].size());
+			merge_ids.emplace_back(i);
+		} else if (idx == NONE) {
+			idx = i;
+		}
+	}
+
+	// merge
+	size_t writes = 0;
+	for (size_t i = 0; i < num_steps; i++) {
+		writes += merge_single_run(main_files, merge_ids, idx, mem_size);
+	}
+
+	// HACK: so it considers empty anchor file when redistributing
+	// does not need to count those writes as they don't really exist
+	writes += redistribute_if_needed(main_files);
+	return writes;
+}
+
 template<typename T>
 pair<vector<T>, double> _polyphasic_sort_from_initial(
 	vector<vector<vector<T>>>& main_files,
-	const int mem_size,
-	const bool verbose
+	const size_t mem_size,
+	const bool verbose,
+	PhaseProfiler* profiler = nullptr,
+	Checkpoint* checkpoint = nullptr
 ){
-	constexpr int INF = std::numeric_limits<int>::max();
+	constexpr size_t NONE = std::numeric_limits<size_t>::max();
+	// phases already done by an interrupted run of this sort (0 if starting from the initial runs)
+	const size_t phases_done = checkpoint ? checkpoint->phase() : 0;
 
 	Observer watcher(std::cout);
-	watcher.step = 1;
-	const int num_files = main_files.size();
-	int anchor_idx = num_files;
+	watcher.step = 1 + phases_done;
 
-	int n = 0;
+	size_t n = 0;
 	for (const auto& file: main_files) {
 		for (const auto& run: file) n += run.size();
 	}
-	int writes = 0;
+	size_t writes = checkpoint ? checkpoint->writes() : 0;
 
 	auto remaining_runs = [&main_files]() {
-		int runs = 0;
+		size_t runs = 0;
 		for (const auto& file: main_files) {
 			runs += file.size();
 		}
@@ -44,36 +85,23 @@ pair<vector<T>, double> _polyphasic_sort_from_initial(
 	// else: merge (T[1],..., T[n-1]) completely into single tape T[n]
 	// swap T[1] and T[n] (it is just a reference swap, inexpensive)
 	// distribute floor(1/(n-1)) of the runs in T[1] to T[i] for all i=2...n-1
-	while (remaining_runs() > 1) {
-		// find minimum of runs on non-empty, and first empty file
-		int num_steps = INF, idx = -1;
-		vector<int> merge_ids;
-		for (int i = 0; i < main_files.size(); i++) {
-			if (!main_files[i].empty()) {
-				num_steps = min(num_steps, (int)main_files[i].size());
-				merge_ids.emplace_back(i);
-			} else if (idx == -1) {
-				idx = i;
-			}
-		}
-
-		// merge
-		for (int i = 0; i < num_steps; i++) {
-			writes += merge_single_run(main_files, merge_ids, idx, mem_size);
+	for (size_t phase = phases_done + 1; remaining_runs() > 1; phase++) {
+		if (profiler) profiler->begin("merge " + std::to_string(phase));
+		const size_t phase_writes = polyphase_step(main_files, mem_size);
+		if (profiler) profiler->end(phase_writes);
+		writes += phase_writes;
+		if (checkpoint) {
+			checkpoint->save(SortMethod::Polyphasic, mem_size, main_files, phase, writes);
 		}
 
-		// HACK: so it considers empty anchor file when redistributing
-		// does not need to count those writes as they don't really exist
-		writes += redistribute_if_needed(main_files);
-
 		// register
 		if (verbose) {
 			watcher.register_step(main_files, mem_size);
 		}
 	}
 	// find non-empty file, guaranteed to be the single run of the dataset
-	int final_file = -1;
-	for (int i = 0; i < main_files.size(); i++) {
+	size_t final_file = NONE;
+	for (size_t i = 0; i < main_files.size(); i++) {
 		if (!main_files[i].empty()) {
 			final_file = i;
 			break;
@@ -85,24 +113,43 @@ pair<vector<T>, double> _polyphasic_sort_from_initial(
 template<typename T>
 vector<T> polyphasic_sort(
 	vector<T> data,
-	const int num_files,
-	const int mem_size,
-	const bool verbose
+	const size_t num_files,
+	const size_t mem_size,
+	const bool verbose,
+	PhaseProfiler* profiler,
+	Checkpoint* checkpoint
 ){
 	// TODO: allow other output streams?
 	Observer watcher(std::cout);
-	vector<vector<vector<T>>> files(num_files - 1);
+	vector<vector<vector<T>>> files;
 
-	perform_initial_distribution(data, files, mem_size);
-	if (verbose) {
-		watcher.register_step(files, mem_size);
+	// input the manifests of this sort are saved for
+	const InputDigest input = checkpoint ? InputDigest::of(data) : InputDigest();
+	if (checkpoint && checkpoint->exists()) {
+		// resume an interrupted sort of the same input from its last completed phase
+		files = checkpoint->load<T>(SortMethod::Polyphasic, num_files, mem_size, input);
+	} else {
+		files.resize(num_files - 1);
+		if (profiler) profiler->begin("runs");
+		perform_initial_distribution(data, files, mem_size);
+		if (profiler) profiler->end(data.size());
+		if (verbose) {
+			watcher.register_step(files, mem_size);
+		}
+		// add file for merging
+		files.emplace_back();
+		if (checkpoint) {
+			checkpoint->set_input(input);
+			checkpoint->save(SortMethod::Polyphasic, mem_size, files, 0, 0);
+		}
 	}
-	// add file for merging
-	files.emplace_back();
 
 	auto[sorted_data, avg_writes] = _polyphasic_sort_from_initial(
-		files, mem_size, verbose
+		files, mem_size, verbose, profiler, checkpoint
 	);
+	if (checkpoint) {
+		checkpoint->clear();
+	}
 
 	if (verbose){
 		std::cout << "final " << std::fixed << std::setprecision(2) << avg_writes << std::endl;
@@ -0,0 +1,52 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include "utils.hpp"
+
+// result of a count-only run of one of the sorting schedules
+struct SimulationReport {
+	std::size_t n = 0;                          // number of records
+	std::size_t initial_runs = 0;               // runs after the initial distribution
+	std::size_t passes = 0;                     // phases after the initial distribution
+	std::vector<std::size_t> writes_per_phase;  // records written in each phase
+	double alpha = 0.0;                         // average writes per record
+};
+
+// splits n records into runs of `run_length` (the last one may be shorter)
+// and deals them round-robin into `num_files` tapes, like perform_initial_distribution
+std::vector<RunLengthTape> initial_run_lengths(std::size_t n, std::size_t num_files, std::size_t run_length);
+
+// same distribution as initial_run_lengths, computed per tape instead of per run
+// (so n / run_length may be far beyond what could be stored run by run)
+std::vector<RunGroupTape> initial_run_groups(std::size_t n, std::size_t num_files, std::size_t run_length);
+
+// drops the payload of a set of tapes, keeping only the length of each run
+template<typename T>
+std::vector<RunLengthTape> to_run_lengths(const std::vector<std::vector<std::vector<T>>>& files);
+
+// count-only counterparts of _balanced_sort_from_initial,
+// _polyphasic_sort_from_initial and _cascade_sort_from_initial
+SimulationReport simulate_balanced_from_initial(
+	std::vector<RunLengthTape> left, std::size_t right_files, std::size_t mem_size
+);
+SimulationReport simulate_polyphasic_from_initial(std::vector<RunLengthTape> files, std::size_t mem_size);
+SimulationReport simulate_cascade_from_initial(std::vector<RunLengthTape> files, std::size_t mem_size);
+
+// predicts the passes and writes of sorting n records with `num_files` tapes and memory `mem_size`
+// run_length is the length of the initial runs (0 means 2 * mem_size, the expected length
+// of replacement selection runs over random data)
+SimulationReport simulate_sort(
+	SortMethod method, std::size_t n, std::size_t num_files, std::size_t mem_size, std::size_t run_length = 0
+);
+
+// include template implementations
+#include "simulation.tpp"
+
+#endif //SIMULATION_HPP
@@ -0,0 +1,179 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "balanced_sort.hpp"
+#include "cascade_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "utils.hpp"
+
+using std::vector;
+
+inline vector<RunLengthTape> initial_run_lengths(
+	const size_t n,
+	const size_t num_files,
+	const size_t run_length
+) {
+	assert(run_length > 0);
+	vector<RunLengthTape> files(num_files);
+	size_t file_idx = 0;
+	for (size_t remaining = n; remaining > 0;) {
+		const size_t length = std::min(remaining, run_length);
+		files[file_idx].emplace_back(length);
+		remaining -= length;
+		file_idx = (file_idx + 1) % num_files;
+	}
+	return files;
+}
+
+inline vector<RunGroupTape> initial_run_groups(
+	const size_t n,
+	const size_t num_files,
+	const size_t run_length
+) {
+	assert(run_length > 0);
+	// run i goes to file i % num_files; only the last run may be shorter
+	const size_t full_runs = n / run_length, last_length = n % run_length;
+	vector<RunGroupTape> files(num_files);
+	for (size_t i = 0; i < num_files; i++) {
+		files[i].push_back(run_length, full_runs / num_files + (i < full_runs % num_files ? 1 : 0));
+	}
+	if (last_length > 0) {
+		files[full_runs % num_files].push_back(last_length);
+	}
+	return files;
+}
+
+template<typename T>
+vector<RunLengthTape> to_run_lengths(const vector<vector<vector<T>>>& files) {
+	vector<RunLengthTape> lengths(files.size());
+	for (size_t i = 0; i < files.size(); i++) {
+		for (const vector<T>& run: files[i]) {
+			lengths[i].emplace_back(run.size());
+		}
+	}
+	return lengths;
+}
+
+namespace SimulationDetail {
+	inline size_t count_records(const vector<RunLengthTape>& files) {
+		size_t n = 0;
+		for (const auto& file: files) {
+			for (const size_t run: file) {
+				n += run;
+			}
+		}
+		return n;
+	}
+
+	inline size_t count_runs(const vector<RunLengthTape>& files) {
+		size_t runs = 0;
+		for (const auto& file: files) {
+			runs += file.size();
+		}
+		return runs;
+	}
+
+	inline void register_phase(SimulationReport& report, const size_t writes) {
+		report.writes_per_phase.emplace_back(writes);
+		++report.passes;
+	}
+
+	inline void finish(SimulationReport& report) {
+		size_t writes = 0;
+		for (const size_t phase_writes: report.writes_per_phase) {
+			writes += phase_writes;
+		}
+		report.alpha = (report.n == 0) ? 0.0 : double(writes) / double(report.n);
+	}
+}
+
+inline SimulationReport simulate_balanced_from_initial(
+	vector<RunLengthTape> left,
+	const size_t right_files,
+	const size_t /* mem_size */
+) {
+	SimulationReport report;
+	report.n = SimulationDetail::count_records(left);
+	report.initial_runs = SimulationDetail::count_runs(left);
+
+	const size_t left_files = left.size();
+	vector<RunLengthTape> right(right_files);
+	// same stop condition as _balanced_sort_from_initial (a single run in the first tape)
+	while (report.initial_runs > 0 && !(left[0].size() == 1 && SimulationDetail::count_runs(left) == 1)) {
+		SimulationDetail::register_phase(report, p_way_merge(left, right));
+		left.clear();
+		left.resize(left_files);
+		std::swap(left, right);
+	}
+	SimulationDetail::finish(report);
+	return report;
+}
+
+inline SimulationReport simulate_polyphasic_from_initial(
+	vector<RunLengthTape> files,
+	const size_t mem_size
+) {
+	SimulationReport report;
+	report.n = SimulationDetail::count_records(files);
+	report.initial_runs = SimulationDetail::count_runs(files);
+
+	while (SimulationDetail::count_runs(files) > 1) {
+		SimulationDetail::register_phase(report, polyphase_step(files, mem_size));
+	}
+	SimulationDetail::finish(report);
+	return report;
+}
+
+inline SimulationReport simulate_cascade_from_initial(
+	vector<RunLengthTape> files,
+	const size_t mem_size
+) {
+	SimulationReport report;
+	report.n = SimulationDetail::count_records(files);
+	report.initial_runs = SimulationDetail::count_runs(files);
+
+	while (report.initial_runs > 0 && !is_finished(files)) {
+		size_t writes = merge_step(files, mem_size);
+		writes += redistribute_if_needed(files);
+		SimulationDetail::register_phase(report, writes);
+	}
+	SimulationDetail::finish(report);
+	return report;
+}
+
+inline SimulationReport simulate_sort(
+	const SortMethod method,
+	const size_t n,
+	const size_t num_files,
+	const size_t mem_size,
+	size_t run_length
+) {
+	if (run_length == 0) {
+		run_length = 2 * mem_size;
+	}
+	switch (method) {
+		case SortMethod::Balanced: {
+			const size_t left_files = (num_files + 1) / 2, right_files = num_files / 2;
+			return simulate_balanced_from_initial(
+				initial_run_lengths(n, left_files, run_length), right_files, mem_size
+			);
+		}
+		case SortMethod::Polyphasic: {
+			vector<RunLengthTape> files = initial_run_lengths(n, num_files - 1, run_length);
+			files.emplace_back();
+			return simulate_polyphasic_from_initial(files, mem_size);
+		}
+		case SortMethod::Cascade: {
+			vector<RunLengthTape> files = initial_run_lengths(n, num_files - 1, run_length);
+			files.emplace_back();
+			return simulate_cascade_from_initial(files, mem_size);
+		}
+	}
+	throw std::invalid_argument("invalid sorting method");
+}
@@ -0,0 +1,168 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef SORT_SCHEDULER_HPP
+#define SORT_SCHEDULER_HPP
+
+#include <vector>
+#include <deque>
+#include <future>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+
+#include "balanced_sort.hpp"
+#include "cascade_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+// shared budget of records held in memory by all running tasks
+// requests that do not fit wait in FIFO order (a later small request never overtakes an older one)
+class MemoryBudget {
+public:
+	explicit MemoryBudget(const std::size_t capacity) : total(capacity) {}
+
+	std::size_t capacity() const {
+		return total;
+	}
+
+	std::size_t in_use() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return used;
+	}
+
+	// largest amount ever in use at once
+	std::size_t peak() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return peak_used;
+	}
+
+	// calls `on_grant` (possibly right away, on this thread) once `amount` records are reserved
+	void acquire(const std::size_t amount, std::function<void()> on_grant) {
+		if (amount > total) {
+			throw std::invalid_argument(
+				"requested " + std::to_string(amount) + " records from a memory budget of " + std::to_string(total)
+			);
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!requests.empty() || used + amount > total) {
+				requests.push_back({amount, std::move(on_grant)});
+				return;
+			}
+			reserve(amount);
+		}
+		on_grant();
+	}
+
+	void release(const std::size_t amount) {
+		std::vector<std::function<void()>> granted;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			used -= amount;
+			grant(granted);
+		}
+		for (auto& on_grant: granted) {
+			on_grant();
+		}
+	}
+
+private:
+	struct Request {
+		std::size_t amount;
+		std::function<void()> on_grant;
+	};
+
+	const std::size_t total;
+	mutable std::mutex mutex;
+	std::size_t used = 0, peak_used = 0;
+	std::deque<Request> requests;
+
+	void reserve(const std::size_t amount) {
+		used += amount;
+		peak_used = std::max(peak_used, used);
+	}
+
+	// grants the requests at the front of the queue while they fit
+	void grant(std::vector<std::function<void()>>& granted) {
+		while (!requests.empty() && used + requests.front().amount <= total) {
+			reserve(requests.front().amount);
+			granted.emplace_back(std::move(requests.front().on_grant));
+			requests.pop_front();
+		}
+	}
+};
+
+// runs many sorts at once on a shared thread pool, under a shared memory budget
+// a job is admitted only when all the records it can hold at once fit in the budget:
+// its n input records, as many in runs (formed while the input is still alive, or written by a
+// merge pass while it reads the previous ones) and its `mem_size` working records, 2n + mem_size;
+// it keeps them until it is done
+// the input of a job waiting for admission is not charged (it was allocated by the caller)
+// each job runs as a run formation task followed by one task per merge phase, and each phase
+// goes behind the tasks already queued, so the merges of admitted jobs interleave
+class SortScheduler {
+public:
+	SortScheduler(const std::size_t num_threads, const std::size_t memory_budget)
+		: budget(memory_budget), pool(num_threads) {}
+
+	// sorts `data` asynchronously as balanced_sort / polyphasic_sort / cascade_sort would
+	// throws std::invalid_argument if the job (2 * data.size() + mem_size records) exceeds the memory budget
+	template<typename T>
+	std::future<std::vector<T>> submit(
+		SortMethod method, std::vector<T> data, std::size_t num_files, std::size_t mem_size
+	);
+
+	const MemoryBudget& memory() const {
+		return budget;
+	}
+
+	std::size_t num_threads() const {
+		return pool.size();
+	}
+
+private:
+	template<typename T>
+	struct SortJob {
+		SortMethod method;
+		std::vector<T> data;
+		std::size_t num_files, mem_size;
+		// records charged to the budget
+		std::size_t charge;
+		std::vector<std::vector<std::vector<T>>> files, right_files;
+		std::promise<std::vector<T>> result;
+	};
+
+	MemoryBudget budget;
+	// declared last: its destructor finishes every queued task while the budget is still alive
+	ThreadPool pool;
+
+	template<typename T>
+	void form_runs(const std::shared_ptr<SortJob<T>>& job);
+
+	// runs one merge phase of the job, then queues the next one (or delivers the result)
+	template<typename T>
+	void merge(const std::shared_ptr<SortJob<T>>& job);
+
+	// single merge phase, same as an iteration of the _from_initial drivers
+	// returns false if the job was already down to a single run
+	template<typename T>
+	static bool merge_phase(SortJob<T>& job);
+
+	// the single run left once all phases are done
+	template<typename T>
+	static std::vector<T> final_run(SortJob<T>& job);
+
+	template<typename T>
+	void finish(const std::shared_ptr<SortJob<T>>& job);
+};
+
+// include template implementations
+#include "sort_scheduler.tpp"
+
+#endif //SORT_SCHEDULER_HPP
@@ -0,0 +1,117 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#pragma once
+
+#include <vector>
+#include <future>
+#include <memory>
+#include <exception>
+
+#include "initial_distribution.hpp"
+#include "utils.hpp"
+
+using std::vector;
+
+template<typename T>
+std::future<vector<T>> SortScheduler::submit(
+	const SortMethod method,
+	vector<T> data,
+	const size_t num_files,
+	const size_t mem_size
+) {
+	auto job = std::make_shared<SortJob<T>>();
+	job->method = method;
+	job->charge = 2 * data.size() + mem_size;
+	job->data = std::move(data);
+	job->num_files = num_files;
+	job->mem_size = mem_size;
+	std::future<vector<T>> future = job->result.get_future();
+
+	budget.acquire(job->charge, [this, job]() {
+		pool.submit([this, job]() { form_runs(job); });
+	});
+	return future;
+}
+
+template<typename T>
+void SortScheduler::form_runs(const std::shared_ptr<SortJob<T>>& job) {
+	try {
+		if (job->method == SortMethod::Balanced) {
+			// same split as balanced_sort
+			job->files.resize((job->num_files + 1) / 2);
+			job->right_files.resize(job->num_files / 2);
+		} else {
+			job->files.resize(job->num_files - 1);
+		}
+		perform_initial_distribution(std::move(job->data), job->files, job->mem_size);
+		job->data = vector<T>();
+		if (job->method != SortMethod::Balanced) {
+			// add file for merging
+			job->files.emplace_back();
+		}
+	} catch (...) {
+		job->result.set_exception(std::current_exception());
+		finish(job);
+		return;
+	}
+	pool.defer([this, job]() { merge(job); });
+}
+
+template<typename T>
+void SortScheduler::merge(const std::shared_ptr<SortJob<T>>& job) {
+	try {
+		if (merge_phase(*job)) {
+			pool.defer([this, job]() { merge(job); });
+			return;
+		}
+		job->result.set_value(final_run(*job));
+	} catch (...) {
+		job->result.set_exception(std::current_exception());
+	}
+	finish(job);
+}
+
+template<typename T>
+bool SortScheduler::merge_phase(SortJob<T>& job) {
+	size_t runs = 0;
+	for (const auto& file: job.files) {
+		runs += file.size();
+	}
+	if (runs <= 1) {
+		return false;
+	}
+	if (job.method == SortMethod::Balanced) {
+		// (a single run is always in the first tape, the one every pass writes first)
+		const size_t left_files = (job.num_files + 1) / 2;
+		p_way_merge(job.files, job.right_files);
+		job.files.clear();
+		job.files.resize(left_files);
+		std::swap(job.files, job.right_files);
+	} else if (job.method == SortMethod::Polyphasic) {
+		polyphase_step(job.files, job.mem_size);
+	} else {
+		merge_step(job.files, job.mem_size);
+		redistribute_if_needed(job.files);
+	}
+	return true;
+}
+
+template<typename T>
+vector<T> SortScheduler::final_run(SortJob<T>& job) {
+	for (auto& file: job.files) {
+		if (!file.empty()) {
+			return std::move(file[0]);
+		}
+	}
+	// empty input
+	return vector<T>();
+}
+
+template<typename T>
+void SortScheduler::finish(const std::shared_ptr<SortJob<T>>& job) {
+	job->data = vector<T>();
+	job->files.clear();
+	job->right_files.clear();
+	budget.release(job->charge);
+}
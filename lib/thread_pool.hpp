@@ -0,0 +1,156 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+// fixed-size pool of worker threads with one task deque per worker
+// a worker takes tasks from the back of its own deque and, when it is empty,
+// steals from the front of the others
+class ThreadPool {
+public:
+	explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency()) {
+		if (num_threads == 0) {
+			num_threads = 1;
+		}
+		for (std::size_t i = 0; i < num_threads; i++) {
+			queues.emplace_back(std::make_unique<WorkQueue>());
+		}
+		for (std::size_t i = 0; i < num_threads; i++) {
+			workers.emplace_back([this, i]() { work(i); });
+		}
+	}
+
+	// finishes all queued tasks before joining the workers
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(idle_mutex);
+			stopping = true;
+		}
+		idle.notify_all();
+		for (auto& worker: workers) {
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	std::size_t size() const {
+		return workers.size();
+	}
+
+	// tasks submitted from a worker go to its own deque, others are spread round-robin
+	void submit(std::function<void()> task) {
+		const std::size_t target = (current_worker() != NO_WORKER)
+			? current_worker()
+			: next_queue.fetch_add(1) % queues.size();
+		{
+			std::lock_guard<std::mutex> lock(queues[target]->mutex);
+			queues[target]->tasks.emplace_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(idle_mutex);
+			++pending;
+		}
+		idle.notify_one();
+	}
+
+	// like submit, but a task deferred from a worker goes behind every task already in its deque
+	// (the worker takes it last, and the others steal it first)
+	void defer(std::function<void()> task) {
+		if (current_worker() == NO_WORKER) {
+			submit(std::move(task));
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(queues[current_worker()]->mutex);
+			queues[current_worker()]->tasks.emplace_front(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(idle_mutex);
+			++pending;
+		}
+		idle.notify_one();
+	}
+
+private:
+	static constexpr std::size_t NO_WORKER = static_cast<std::size_t>(-1);
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<std::size_t> next_queue{0};
+
+	std::mutex idle_mutex;
+	std::condition_variable idle;
+	std::size_t pending = 0;  // queued tasks, guarded by idle_mutex
+	bool stopping = false;
+
+	// pool and index of the worker running on the calling thread
+	inline static thread_local const ThreadPool* local_pool = nullptr;
+	inline static thread_local std::size_t local_worker = NO_WORKER;
+
+	std::size_t current_worker() const {
+		return (local_pool == this) ? local_worker : NO_WORKER;
+	}
+
+	bool try_take(const std::size_t id, std::function<void()>& task) {
+		// own deque first (newest task), then steal the oldest task of the others
+		for (std::size_t k = 0; k < queues.size(); k++) {
+			WorkQueue& queue = *queues[(id + k) % queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty()) {
+				continue;
+			}
+			if (k == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			} else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void work(const std::size_t id) {
+		local_pool = this;
+		local_worker = id;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(idle_mutex);
+				idle.wait(lock, [this]() { return pending > 0 || stopping; });
+				if (pending == 0) {
+					// stopping and nothing left to do
+					return;
+				}
+				--pending;
+			}
+			// a task is reserved for this worker, it may still be in another deque
+			std::function<void()> task;
+			while (!try_take(id, task)) {
+				std::this_thread::yield();
+			}
+			task();
+		}
+	}
+};
+
+#endif //THREAD_POOL_HPP
@@ -6,25 +6,131 @@
 #define UTILS_H
 
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include <queue>
 #include <string>
 #include <iomanip>
 #include <cmath>
 #include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
 
 using std::vector;
+using std::size_t;
 template<typename T>
 using min_priority_queue = std::priority_queue<T, vector<T>, std::greater<T>>;
 
+enum class SortMethod { Balanced, Polyphasic, Cascade };
+
+// count-only tape: each run is represented only by its length (no payload)
+using RunLengthTape = std::deque<size_t>;
+
+// number of records in a run, whether it is stored explicitly or only as its length
+template<typename T>
+size_t run_length(const vector<T>& run) {
+	return run.size();
+}
+
+inline size_t run_length(const size_t run) {
+	return run;
+}
+
+// count-only tape where consecutive runs of the same length are kept as a single group,
+// so a tape of billions of runs takes a few words (runs are read at the front, written at the back)
+class RunGroupTape {
+public:
+	struct Group {
+		size_t length;
+		size_t count;
+
+		bool operator==(const Group& other) const {
+			return length == other.length && count == other.count;
+		}
+	};
+
+	// number of runs
+	size_t size() const {
+		return num_runs;
+	}
+
+	bool empty() const {
+		return num_runs == 0;
+	}
+
+	size_t records() const {
+		size_t n = 0;
+		for (const Group& group: runs) {
+			n += group.length * group.count;
+		}
+		return n;
+	}
+
+	const std::deque<Group>& groups() const {
+		return runs;
+	}
+
+	// appends `count` runs of `length` records
+	void push_back(const size_t length, const size_t count = 1) {
+		if (count == 0) return;
+		if (!runs.empty() && runs.back().length == length) {
+			runs.back().count += count;
+		} else {
+			runs.push_back({length, count});
+		}
+		num_runs += count;
+	}
+
+	// moves the first `count` runs to the back of `to`, in order; returns the records moved
+	size_t move_front(RunGroupTape& to, size_t count) {
+		assert(count <= num_runs);
+		size_t records = 0;
+		while (count > 0) {
+			Group& front = runs.front();
+			const size_t moved = std::min(count, front.count);
+			to.push_back(front.length, moved);
+			records += front.length * moved;
+			front.count -= moved;
+			num_runs -= moved;
+			count -= moved;
+			if (front.count == 0) {
+				runs.pop_front();
+			}
+		}
+		return records;
+	}
+
+private:
+	std::deque<Group> runs;
+	size_t num_runs = 0;
+};
+
+// moves the first `count` runs of `from` to the back of `to`, in order; returns the records moved
+template<typename Tape>
+size_t move_front_runs(Tape& from, Tape& to, const size_t count) {
+	size_t records = 0;
+	for (size_t k = 0; k < count; k++) {
+		records += run_length(from[k]);
+		to.emplace_back(std::move(from[k]));
+	}
+	from.erase(from.begin(), from.begin() + count);
+	return records;
+}
+
+inline size_t move_front_runs(RunGroupTape& from, RunGroupTape& to, const size_t count) {
+	return from.move_front(to, count);
+}
+
 template<typename T>
 struct AlternatingIterator {
     const vector<vector<vector<T>>>& files_ref;
-    int n;
-    int curr_file = 0;
+    size_t n;
+    size_t curr_file = 0;
 	// respectively: index of run, index inside run
-    vector<int> run_index;
-    vector<int> inner_index;
-    int completed_files = 0;
+    vector<size_t> run_index;
+    vector<size_t> inner_index;
+    size_t completed_files = 0;
 
 	AlternatingIterator(
         const vector<vector<vector<T>>> &files
@@ -59,7 +165,7 @@ struct AlternatingIterator {
 			// TODO add exception if ended
 			curr_file = (curr_file + 1) % n;
 			// finished processing
-			int skipped = 0;
+			size_t skipped = 0;
 			while (run_index[curr_file] == files_ref[curr_file].size() && skipped < n){
 				curr_file = (curr_file + 1) % n;
 				++skipped;
@@ -78,77 +184,35 @@ struct AlternatingIterator {
 	}
 };
 
-// struct to represent a value with (possibly) a mark that makes it "act"
-// like infinity in the underlying ordering of its type T
-template<typename T>
-struct MarkedValue{
-    T val;
-	bool marked;
-
-	MarkedValue(T val, bool marked = false): val(val), marked(marked){}
-
-	bool operator< (const MarkedValue<T>& other) const {
-		if (marked and !other.marked){
-			return false;
-		} else if (!marked and other.marked){
-		    return true;
-		} else {
-            return val < other.val;
-        }
-    }
-
-	bool operator== (const MarkedValue<T>& other) const {
-        return val == other.val and marked == other.marked;
-    }
-
-	bool operator> (const MarkedValue<T>& other) const {
-        return other < *this;
-    }
-
-	// type cast to base type T
-	operator T() const{
-        return val;
-    }
-
-	void mark(){
-        marked = true;
-    }
-};
-
-// O(N log N) unmarking of the entire heap
-template<typename T>
-void unmark_all(min_priority_queue<MarkedValue<T>> &min_heap) {
-	vector<T> values;
-	while (!min_heap.empty()) {
-		MarkedValue<T> min_key = min_heap.top();
-		min_heap.pop();
-        values.emplace_back(T(min_key));
-	}
-	for (const T key: values) {
-		min_heap.push(MarkedValue<T>(key));
-	}
-}
-
 struct Observer {
-	int step;
+	size_t step;
 	explicit Observer(std::ostream& os) : step(0), os(os) {}
 
 	template<typename T>
-	static double avg_run_size(const vector<vector<vector<T>>>& active_files, const int mem_size) {
-		int total_elements = 0, total_runs = 0;
+	static double avg_run_size(const vector<vector<vector<T>>>& active_files, const size_t mem_size) {
+		size_t total_elements = 0, total_runs = 0;
 		for (const vector<vector<T>>& file: active_files) {
 			total_runs += file.size();
 			for (const vector<T>& run: file) {
 				total_elements += run.size();
 			}
 		}
-		return static_cast<double>(total_elements) / static_cast<double>(total_runs * mem_size);
+		return static_cast<double>(total_elements) / (static_cast<double>(total_runs) * static_cast<double>(mem_size));
+	}
+
+	static double avg_run_size(const vector<RunGroupTape>& active_files, const size_t mem_size) {
+		size_t total_elements = 0, total_runs = 0;
+		for (const RunGroupTape& file: active_files) {
+			total_runs += file.size();
+			total_elements += file.records();
+		}
+		return static_cast<double>(total_elements) / (static_cast<double>(total_runs) * static_cast<double>(mem_size));
 	}
 
 	template<typename T>
 	void register_step(
 		const vector<vector<vector<T>>>& active_files,
-		const vector<int>& file_idxs, const int mem_size
+		const vector<size_t>& file_idxs, const size_t mem_size
 	) {
 		// precision of two decimal digits (rounding, not truncating)
 		os << std::fixed << std::setprecision(2);
@@ -163,7 +227,7 @@ struct Observer {
 	template<typename T>
 	void register_step(
 		const vector<vector<vector<T>>>& active_files,
-		const int mem_size
+		const size_t mem_size
 	) {
 		// precision of two decimal digits (rounding, not truncating)
 		os << std::fixed << std::setprecision(2);
@@ -184,7 +248,7 @@ private:
 	// file_idxs: vector of indices of the active files
 	// active_files: vector of references to the active files (which are a vector<vector<T>> each)
 	template<typename T>
-	void print_distribution(const vector<vector<vector<T>>>& active_files, const vector<int>& file_idxs) {
+	void print_distribution(const vector<vector<vector<T>>>& active_files, const vector<size_t>& file_idxs) {
 		if (active_files.size() != file_idxs.size()) {
 			const std::string error = (
 				std::string("There should be the same number of indices as files, got ")
@@ -195,14 +259,14 @@ private:
 			);
 			throw std::invalid_argument(error);
 		}
-		for (int i = 0; i < active_files.size(); i++) {
+		for (size_t i = 0; i < active_files.size(); i++) {
 			if (active_files[i].empty()) {
 				continue;
 			}
 			os << file_idxs[i] << ": ";
 			for (const vector<T>& run: active_files[i]) {
 				os << "{";
-				for (int j = 0; j < run.size(); j++) {
+				for (size_t j = 0; j < run.size(); j++) {
 					os << run[j];
 					if (j + 1 < run.size()) {
 						os << " ";
@@ -217,14 +281,14 @@ private:
 	// NOTE: for cascade sort only
 	template<typename T>
 	void print_distribution(const vector<vector<vector<T>>>& active_files) {
-		for (int i = 0; i < active_files.size(); i++) {
+		for (size_t i = 0; i < active_files.size(); i++) {
 			if (active_files[i].empty()) {
 				continue;
 			}
 			os << i + 1 << ": ";
 			for (const vector<T>& run: active_files[i]) {
 				os << "{";
-				for (int j = 0; j < run.size(); j++) {
+				for (size_t j = 0; j < run.size(); j++) {
 					os << run[j];
 					if (j + 1 < run.size()) {
 						os << " ";
@@ -238,12 +302,13 @@ private:
 };
 
 // returns number of writes
-template<typename T>
-int redistribute_if_needed(
-	vector<vector<vector<T>>>& files
+// works both on tapes of runs and on count-only tapes (RunLengthTape, RunGroupTape)
+template<typename Tape>
+size_t redistribute_if_needed(
+	vector<Tape>& files
 ) {
 	auto remaining_runs = [&files]() {
-		int runs = 0;
+		size_t runs = 0;
 		for (const auto& file: files) {
 			runs += file.size();
 		}
@@ -251,35 +316,30 @@ int redistribute_if_needed(
 	};
 
 	// find first file with many runs
-	int idx = -1;
-	for (int i = 0; i < files.size(); i++) {
+	constexpr size_t NONE = std::numeric_limits<size_t>::max();
+	size_t idx = NONE;
+	for (size_t i = 0; i < files.size(); i++) {
 		if (files[i].size() > 1) {
 			idx = i;
 			break;
 		}
 	}
 
-	const int num_files = files.size();
-	int writes = 0;
+	const size_t num_files = files.size();
+	size_t writes = 0;
 	// only main_files[idx] is occupied and with > 1 runs
 	// Solution: distribute runs from main_files[idx]
 	// num_files is >= 3 so run_amount is == 0 when there is only a single run in main_files[0]
 	// (process finished)
-	if (idx != -1 && remaining_runs() == files[idx].size()) {
-		// so that pop_back() becomes pop_front()
-		// NOTE: does not need to reverse again later, will become empty
-		std::reverse(files[idx].begin(), files[idx].end());
-		const int run_amount = files[idx].size() / (num_files - 1);
-		const int remainder = files[idx].size() % (num_files - 1);
-		int j = 0;
-		for (int i = 0; i < files.size(); i++) {
+	if (idx != NONE && remaining_runs() == files[idx].size()) {
+		// each other file takes the next run_amount (+1) runs, from the front
+		const size_t run_amount = files[idx].size() / (num_files - 1);
+		const size_t remainder = files[idx].size() % (num_files - 1);
+		size_t j = 0;
+		for (size_t i = 0; i < files.size(); i++) {
 			if (i == idx) continue;
-			const int extra_run = (j < remainder) ? 1 : 0;
-			for (int k = 0; k < run_amount + extra_run; k++) {
-				writes += files[idx].back().size();
-				files[i].emplace_back(files[idx].back());
-				files[idx].pop_back();
-			}
+			const size_t extra_run = (j < remainder) ? 1 : 0;
+			writes += move_front_runs(files[idx], files[i], run_amount + extra_run);
 			++j;
 		}
 	}
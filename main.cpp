@@ -10,17 +10,17 @@
 #include "cascade_sort.hpp"
 #include "polyphasic_sort.hpp"
 
-using std::vector, std::string, std::cin;
+using std::vector, std::string, std::cin, std::size_t;
 
 int main(){
     string mode;
-    int m, k, r, n;
+    size_t m, k, r, n;
     vector<int> data;
 
     cin >> mode;
     cin >> m >> k >> r >> n;
     data.resize(n);
-    for (int i = 0; i < n; i++) {
+    for (size_t i = 0; i < n; i++) {
         cin >> data[i];
     }
 
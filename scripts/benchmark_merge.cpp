@@ -0,0 +1,93 @@
+// Script for comparing the compile-time specialized merge against the generic heap merge
+// usage: benchmark_merge <fan-in> <run size> [reps] [random|presorted|streaks]
+// random: independent random runs, the winner changes almost every record
+// presorted: runs cover consecutive key ranges, so each run wins one long streak
+// streaks: blocks of 16 to 256 consecutive keys dealt to random runs, so streaks of every run interleave
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "merge_kernel.hpp"
+
+using std::vector;
+
+// best time of `reps` merges: the output keeps its capacity across repetitions (and a warm-up),
+// so page faults are not timed, and other load on the machine only ever adds time
+template<typename Merge>
+double time_merge(const vector<const vector<int>*>& runs, const int reps, vector<int>& out, Merge merge) {
+    out.clear();
+    merge(runs, out);
+    double best_ms = 0.0;
+    for (int i = 0; i < reps; i++) {
+        out.clear();
+        const auto start = std::chrono::steady_clock::now();
+        merge(runs, out);
+        const auto end = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        best_ms = (i == 0) ? ms : std::min(best_ms, ms);
+    }
+    return best_ms;
+}
+
+vector<vector<int>> make_runs(const size_t fan_in, const size_t run_size, const std::string& pattern) {
+    std::mt19937 rng(0);
+    vector<vector<int>> runs(fan_in);
+    if (pattern == "streaks") {
+        std::uniform_int_distribution<size_t> block(16, 256), owner(0, fan_in - 1);
+        int key = 0;
+        while (true) {
+            // a block of consecutive keys goes to a run with room left
+            size_t i = owner(rng);
+            for (size_t tries = 0; tries < fan_in && runs[i].size() == run_size; tries++) {
+                i = (i + 1) % fan_in;
+            }
+            if (runs[i].size() == run_size) break;
+            for (size_t length = block(rng); length > 0 && runs[i].size() < run_size; length--) {
+                runs[i].push_back(key++);
+            }
+        }
+        return runs;
+    }
+    for (size_t i = 0; i < fan_in; i++) {
+        for (size_t j = 0; j < run_size; j++) {
+            runs[i].push_back(pattern == "presorted" ? int(i * run_size + j) : int(rng() >> 1));
+        }
+        std::sort(runs[i].begin(), runs[i].end());
+    }
+    return runs;
+}
+
+int main(int argc, char** argv){
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <fan-in> <run size> [reps] [random|presorted|streaks]" << std::endl;
+        return 1;
+    }
+    const size_t fan_in = std::stoull(argv[1]);
+    const size_t run_size = std::stoull(argv[2]);
+    const int reps = (argc > 3) ? std::stoi(argv[3]) : 10;
+    const std::string pattern = (argc > 4) ? argv[4] : "random";
+
+    const vector<vector<int>> runs = make_runs(fan_in, run_size, pattern);
+    vector<const vector<int>*> ptrs;
+    for (const auto& run: runs) {
+        ptrs.emplace_back(&run);
+    }
+
+    vector<int> out;
+    out.reserve(fan_in * run_size);
+    const double fixed_ms = time_merge(ptrs, reps, out, [](const auto& r, auto& o) { return merge_runs(r, o); });
+    const double generic_ms = time_merge(ptrs, reps, out, [](const auto& r, auto& o) { return merge_runs_generic(r, o); });
+    const double copy_ms = time_merge(ptrs, reps, out, [](const auto& r, auto& o) {
+        for (const auto* run: r) o.insert(o.end(), run->begin(), run->end());
+        return o.size();
+    });
+    const double records = double(fan_in * run_size);
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "dispatched " << fixed_ms << " ms (" << 1e6 * fixed_ms / records << " ns/record)" << std::endl;
+    std::cout << "generic    " << generic_ms << " ms (" << 1e6 * generic_ms / records << " ns/record)" << std::endl;
+    std::cout << "plain copy " << copy_ms << " ms (" << 1e6 * copy_ms / records << " ns/record)" << std::endl;
+}
@@ -0,0 +1,65 @@
+// Helpers for running the alpha/beta experiments as independent, seeded tasks on a thread pool
+#ifndef EXPERIMENT_HARNESS_HPP
+#define EXPERIMENT_HARNESS_HPP
+
+#include <vector>
+#include <future>
+#include <memory>
+#include <random>
+#include <cstdint>
+#include <functional>
+
+#include "thread_pool.hpp"
+
+namespace Experiment {
+    using Rng = std::mt19937_64;
+
+    // seed of the RNG stream of task `index` (splitmix64 of the base seed and the index),
+    // so a task draws the same numbers whichever thread runs it and in whatever order
+    inline std::uint64_t task_seed(const std::uint64_t base_seed, const std::uint64_t index) {
+        std::uint64_t z = base_seed + 0x9e3779b97f4a7c15ULL * (index + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    inline int randint(Rng& rng, const int min_element, const int max_element) {
+        return std::uniform_int_distribution<int>(min_element, max_element)(rng);
+    }
+
+    inline std::vector<int> random_vector(Rng& rng, const size_t size, const int min_element, const int max_element) {
+        std::uniform_int_distribution<int> dist(min_element, max_element);
+        std::vector<int> gen(size);
+        for (int& x: gen) {
+            x = dist(rng);
+        }
+        return gen;
+    }
+
+    // runs task(index, rng) for every index in [0, num_tasks) on the pool, each with its own RNG stream
+    // the results are collected through the returned futures, in task order
+    template<typename Result>
+    std::vector<std::future<Result>> run_tasks(
+        ThreadPool& pool,
+        const size_t num_tasks,
+        const std::uint64_t base_seed,
+        const std::function<Result(size_t, Rng&)>& task
+    ) {
+        std::vector<std::future<Result>> results;
+        for (size_t index = 0; index < num_tasks; index++) {
+            auto promise = std::make_shared<std::promise<Result>>();
+            results.emplace_back(promise->get_future());
+            pool.submit([promise, index, base_seed, &task]() {
+                Rng rng(task_seed(base_seed, index));
+                try {
+                    promise->set_value(task(index, rng));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+        }
+        return results;
+    }
+}
+
+#endif //EXPERIMENT_HARNESS_HPP
@@ -1,70 +1,65 @@
 // Script for generating random runs (of unit size of random size)
 // and distributing them evenly accross files
+// usage: generate_alpha_stat <seed> [threads]
+// every (method, k, r, m, rep) sort is an independent task with its own RNG stream,
+// so the output only depends on the seed, not on the number of threads
 #include <vector>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <iomanip>
 #include <string>
+#include <thread>
 
 #include "cascade_sort.hpp"
 #include "balanced_sort.hpp"
 #include "polyphasic_sort.hpp"
+#include "experiment_harness.hpp"
 
 using std::vector, std::string;
 
 namespace RandomRuns {
-    vector<int> random_vector(size_t size, int min_element, int max_element) {
-        vector<int> gen(size);
-        for (int i = 0; i < size; i++) {
-            const int val = rand() % (max_element - min_element + 1);
-            gen[i] = min_element + val;
-        }
-        return gen;
-    }
-
-    int randint(int min_element, int max_element) {
-        return rand() % (max_element - min_element + 1) + min_element;
-    }
-
-
     vector<vector<vector<int>>> random_runs(
+        Experiment::Rng& rng,
         const int num_runs,
         const int num_files,
         const int max_run_size
     ){
         vector<vector<vector<int>>> files(num_files);
         for (int i = 0; i < num_runs; i++){
-            vector<int> r = random_vector(randint(1, max_run_size), -(int)1e4, +(int)1e4);
-            files[i % num_files].emplace_back(r);
+            const int size = Experiment::randint(rng, 1, max_run_size);
+            files[i % num_files].emplace_back(Experiment::random_vector(rng, size, -(int)1e4, +(int)1e4));
         }
         return files;
     }
 
     vector<vector<vector<int>>> unit_random_runs(
+        Experiment::Rng& rng,
         const int num_runs,
         const int num_files
     ){
-        return random_runs(num_runs, num_files, 1);
+        return random_runs(rng, num_runs, num_files, 1);
     }
 }
 
-double exec_sorting_method(const string name, const int num_runs, const int num_files, const int mem_size){
+double exec_sorting_method(Experiment::Rng& rng, const string name, const int num_runs, const int num_files, const int mem_size){
     if (name == "cascade"){
-        vector<vector<vector<int>>> files = RandomRuns::unit_random_runs(num_runs, num_files - 1);
+        vector<vector<vector<int>>> files = RandomRuns::unit_random_runs(rng, num_runs, num_files - 1);
         files.emplace_back(); // empty file for merge
         auto[sorted_data, avg_writes] = _cascade_sort_from_initial(
             files, mem_size, false
         );
         return avg_writes;
     } else if (name == "polyphasic"){
-        vector<vector<vector<int>>> files = RandomRuns::unit_random_runs(num_runs, num_files - 1);
+        vector<vector<vector<int>>> files = RandomRuns::unit_random_runs(rng, num_runs, num_files - 1);
         files.emplace_back(); // empty file for merge
         auto[sorted_data, avg_writes] = _polyphasic_sort_from_initial(
             files, mem_size, false
         );
         return avg_writes;
     } else if (name == "balanced"){
-        vector<vector<vector<int>>> left = RandomRuns::unit_random_runs(num_runs, num_files / 2);
+        vector<vector<vector<int>>> left = RandomRuns::unit_random_runs(rng, num_runs, num_files / 2);
         vector<vector<vector<int>>> right(num_files / 2);
         auto[sorted_data, avg_writes] = _balanced_sort_from_initial(
             left, right, mem_size, false
@@ -76,18 +71,18 @@ double exec_sorting_method(const string name, const int num_runs, const int num_
 }
 
 int main(int argc, char** argv){
-    int seed = std::stoi(argv[1]);
-    srand(seed);
+    const std::uint64_t seed = std::stoull(argv[1]);
+    const size_t num_threads = (argc > 2) ? std::stoull(argv[2]) : std::thread::hardware_concurrency();
 
     std::filesystem::create_directories("data");
     std::filesystem::create_directories("data/alpha");
     const string BASE_DIR = "data/alpha";
-    auto methods = { "polyphasic" };
+    const vector<string> methods = { "balanced", "cascade", "polyphasic" };
 
     // see docs for homework
     const int REPS = 10;
-    auto k_values = {4, 6, 8, 10, 12};
-    auto m_values = {3, 15, 30, 45, 60};
+    const vector<int> k_values = {4, 6, 8, 10, 12};
+    const vector<int> m_values = {3, 15, 30, 45, 60};
     vector<int> r_values;
     for (int j = 10; j <= 1000; j += 10) {
         r_values.emplace_back(j);
@@ -95,9 +90,27 @@ int main(int argc, char** argv){
     std::sort( r_values.begin(), r_values.end() );
     r_values.erase( std::unique( r_values.begin(), r_values.end() ), r_values.end() );
 
+    // task index = ((((method * |k|) + k) * |r| + r) * |m| + m) * REPS + rep
+    const size_t tasks_per_line = m_values.size() * REPS;
+    const size_t num_tasks = methods.size() * k_values.size() * r_values.size() * tasks_per_line;
+    const std::function<double(size_t, Experiment::Rng&)> task = [&](size_t index, Experiment::Rng& rng) {
+        const int m = m_values[(index / REPS) % m_values.size()];
+        index /= tasks_per_line;
+        const int r = r_values[index % r_values.size()];
+        index /= r_values.size();
+        const int k = k_values[index % k_values.size()];
+        const string& method = methods[index / k_values.size()];
+        return exec_sorting_method(rng, method, r, k, m);
+    };
+
     // flush always after each operation
     std::cout.setf(std::ios::unitbuf);
 
+    ThreadPool pool(num_threads);
+    auto results = Experiment::run_tasks(pool, num_tasks, seed, task);
+
+    // results are consumed (and summed) in task order, so the output does not depend on scheduling
+    size_t next_result = 0;
     for (const string& method: methods){
         for (const int k: k_values) {
             string filepath = BASE_DIR + "/" + method + "-" + std::to_string(k) + "-files.txt";
@@ -105,10 +118,8 @@ int main(int argc, char** argv){
             std::ofstream outfile (filepath);
             for (const auto r: r_values){
                 double avg_alpha = 0.0;
-                for (auto m: m_values) {
-                    for (int i = 0; i < REPS; i++){
-                        avg_alpha += exec_sorting_method(method, r, k, m) / double(REPS * m_values.size());
-                    }
+                for (size_t i = 0; i < tasks_per_line; i++) {
+                    avg_alpha += results[next_result++].get() / double(tasks_per_line);
                 }
                 std::cout << r << " : " << std::fixed << std::setprecision(4) << avg_alpha << std::endl;
                 outfile << r << " : " << std::fixed << std::setprecision(4) << avg_alpha << std::endl;
@@ -116,4 +127,4 @@ int main(int argc, char** argv){
             outfile.close();
         }
     }
-}
\ No newline at end of file
+}
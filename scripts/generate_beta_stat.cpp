@@ -1,51 +1,57 @@
 //
 // Created by igor-borja on 8/15/24.
 //
+// usage: generate_beta_stat <output file> [seed] [threads]
+// every (m, rep) measurement is an independent task; the dataset of a rep is drawn
+// from the RNG stream of that rep, so the output only depends on the seed
 #include <iostream>
+#include <iomanip>
 #include <vector>
+#include <thread>
 
 #include "initial_distribution.hpp"
 #include "utils.hpp"
+#include "experiment_harness.hpp"
 
 const int N = 1e6;
 const int MAX_M = 100;
 const int DELTA = 5;
 
-std::vector<int> random_vector(size_t size, int min_element, int max_element) {
-    std::vector<int> gen(size);
-    for (int i = 0; i < size; i++) {
-        const int val = rand() % (max_element - min_element + 1);
-        gen[i] = min_element + val;
-    }
-    return gen;
-}
-
 int main(int argc, char* argv[]){
     // small output optimization
     std::ios_base::sync_with_stdio(false);
 
     freopen(argv[1], "w", stdout);
+    const std::uint64_t seed = (argc > 2) ? std::stoull(argv[2]) : 0;
+    const size_t num_threads = (argc > 3) ? std::stoull(argv[3]) : std::thread::hardware_concurrency();
 
     // see docs for homework
     const int REPS = 10;
-    auto m_values = {3, 15, 30, 45, 60};
-
-    std::vector<int> data[REPS];
-    for (int i = 0; i < REPS; i++){
-        data[i] = random_vector(N, -1e9, 1e9);
-    }
-
+    const std::vector<int> m_values = {3, 15, 30, 45, 60};
+
+    // task index = m * REPS + rep
+    const std::function<double(size_t, Experiment::Rng&)> task = [&](size_t index, Experiment::Rng&) {
+        const int m = m_values[index / REPS];
+        // same dataset for a given rep whatever the value of m
+        Experiment::Rng data_rng(Experiment::task_seed(seed, index % REPS));
+        const std::vector<int> data = Experiment::random_vector(data_rng, N, -1e9, 1e9);
+        // only 1 file is fine
+        std::vector<std::vector<std::vector<int>>> files(1);
+        perform_initial_distribution(data, files, m);
+        // calculate beta
+        return Observer::avg_run_size(files, m);
+    };
+
+    ThreadPool pool(num_threads);
+    auto results = Experiment::run_tasks(pool, m_values.size() * REPS, seed, task);
+
+    size_t next_result = 0;
     for (const int m: m_values){
-        double beta[REPS];
         std::cout << m << ":" << std::endl;
         for (int i = 0; i < REPS; i++){
-            // only 1 file is fine
-            std::vector<std::vector<std::vector<int>>> files(1);
-            perform_initial_distribution(data[i], files, m);
-            // calculate beta
-            double beta = Observer::avg_run_size(files, m);
+            const double beta = results[next_result++].get();
             std::cout << std::fixed << std::setprecision(4) << beta << " ";
         }
         std::cout << std::endl;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,46 @@
+// Script for predicting the passes and writes of a sort without moving any data
+// usage: simulate_sort <B|P|C> <n> <m> <k> [run length]
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+
+#include "simulation.hpp"
+
+using std::string;
+
+int main(int argc, char** argv){
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " <B|P|C> <n> <m> <k> [run length]" << std::endl;
+        return 1;
+    }
+    const string mode = argv[1];
+    const size_t n = std::stoull(argv[2]);
+    const size_t m = std::stoull(argv[3]);
+    const size_t k = std::stoull(argv[4]);
+    const size_t run_length = (argc > 5) ? std::stoull(argv[5]) : 0;
+
+    SortMethod method;
+    if (mode == "B") {
+        method = SortMethod::Balanced;
+    } else if (mode == "P") {
+        method = SortMethod::Polyphasic;
+    } else if (mode == "C") {
+        method = SortMethod::Cascade;
+    } else {
+        std::cerr << "invalid sorting method " << mode << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const SimulationReport report = simulate_sort(method, n, k, m, run_length);
+    const auto end = std::chrono::steady_clock::now();
+
+    std::cout << "runs " << report.initial_runs << std::endl;
+    for (size_t i = 0; i < report.writes_per_phase.size(); i++) {
+        std::cout << "fase " << i + 1 << " " << report.writes_per_phase[i] << std::endl;
+    }
+    std::cout << "passes " << report.passes << std::endl;
+    std::cout << "final " << std::fixed << std::setprecision(2) << report.alpha << std::endl;
+    std::cout << "simulated in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+}
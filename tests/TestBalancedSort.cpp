@@ -118,6 +118,15 @@ TEST(test_balanced_sort, parametrized_mostly_equal_huge_random_test_sort) {
     }
 }
 
+TEST(test_balanced_sort, test_sort_mem_size_above_int_range) {
+    const size_t mem_size = 3'000'000'000ULL;
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    const vector<int> sorted_data = balanced_sort(data, 4, mem_size, false);
+    vector<int> expected_sorted_data = data;
+    sort(expected_sorted_data.begin(), expected_sorted_data.end());
+    ASSERT_EQ(sorted_data, expected_sorted_data);
+}
+
 int main() {
     testing::InitGoogleTest();
     return RUN_ALL_TESTS();
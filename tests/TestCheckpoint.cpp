@@ -0,0 +1,217 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+#include <filesystem>
+#include <ostream>
+#include <gtest/gtest.h>
+
+#include "polyphasic_sort.hpp"
+#include "cascade_sort.hpp"
+#include "checkpoint.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+const std::string CHECKPOINT_PATH = (std::filesystem::temp_directory_path() / "test_checkpoint.bin").string();
+
+TEST(test_checkpoint, test_save_and_load) {
+    const vector<vector<vector<int>>> files = {{{1, 5, 6}, {2}}, {}, {{3, 4}}};
+    const InputDigest input = InputDigest::of(vector<int>{6, 2, 1, 5, 4, 3});
+    Checkpoint checkpoint(CHECKPOINT_PATH);
+    checkpoint.set_input(input);
+    checkpoint.save(SortMethod::Cascade, 3, files, 2, 17);
+    ASSERT_TRUE(checkpoint.exists());
+
+    // a restarted process only has the path and the input
+    Checkpoint restarted(CHECKPOINT_PATH);
+    ASSERT_EQ(restarted.phase(), 0);
+    ASSERT_EQ(restarted.load<int>(SortMethod::Cascade, 3, 3, input), files);
+    ASSERT_EQ(restarted.phase(), 2);
+    ASSERT_EQ(restarted.writes(), 17);
+    ASSERT_EQ(restarted.input(), input);
+
+    restarted.clear();
+    ASSERT_FALSE(restarted.exists());
+    ASSERT_EQ(restarted.phase(), 0);
+}
+
+TEST(test_checkpoint, test_invalid_manifest) {
+    const vector<vector<vector<int>>> files = {{{1, 5, 6}, {2}}, {}, {{3, 4}}};
+    const InputDigest input = InputDigest::of(vector<int>{6, 2, 1, 5, 4, 3});
+    Checkpoint checkpoint(CHECKPOINT_PATH);
+    checkpoint.clear();
+    ASSERT_THROW(checkpoint.load<int>(SortMethod::Cascade, 3, 3, input), std::runtime_error);
+
+    checkpoint.set_input(input);
+    checkpoint.save(SortMethod::Cascade, 3, files, 2, 17);
+    ASSERT_THROW(checkpoint.load<int>(SortMethod::Polyphasic, 3, 3, input), std::invalid_argument);
+    ASSERT_THROW(checkpoint.load<int>(SortMethod::Cascade, 4, 3, input), std::invalid_argument);
+    ASSERT_THROW(checkpoint.load<int>(SortMethod::Cascade, 3, 5, input), std::invalid_argument);
+    ASSERT_THROW(checkpoint.load<long long>(SortMethod::Cascade, 3, 3, input), std::invalid_argument);
+    // same parameters, other input: same size with one record changed, or another size
+    ASSERT_THROW(
+        checkpoint.load<int>(SortMethod::Cascade, 3, 3, InputDigest::of(vector<int>{6, 2, 1, 5, 4, 7})),
+        std::invalid_argument
+    );
+    ASSERT_THROW(
+        checkpoint.load<int>(SortMethod::Cascade, 3, 3, InputDigest::of(vector<int>{6, 2, 1, 5, 4})),
+        std::invalid_argument
+    );
+
+    // cut in the middle of the last run
+    std::filesystem::resize_file(CHECKPOINT_PATH, std::filesystem::file_size(CHECKPOINT_PATH) - 2);
+    ASSERT_THROW(checkpoint.load<int>(SortMethod::Cascade, 3, 3, input), std::runtime_error);
+    checkpoint.clear();
+}
+
+TEST(test_checkpoint, parametrized_polyphasic_resume) {
+    for (int i = 0; i < 10; i++) {
+        const int num_files = RandomDataFixture::randint(3, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        vector<int> expected = data;
+        sort(expected.begin(), expected.end());
+
+        vector<vector<vector<int>>> files(num_files - 1);
+        perform_initial_distribution(data, files, mem_size);
+        files.emplace_back();
+        vector<vector<vector<int>>> uninterrupted = files;
+        const double alpha = _polyphasic_sort_from_initial(uninterrupted, mem_size, false).second;
+
+        // the sort gets killed after a few phases, right after saving the last one
+        Checkpoint checkpoint(CHECKPOINT_PATH);
+        checkpoint.set_input(InputDigest::of(data));
+        size_t writes = 0;
+        const int phases = RandomDataFixture::randint(0, 3);
+        for (int phase = 1; phase <= phases && !is_finished(files); phase++) {
+            writes += polyphase_step(files, mem_size);
+            checkpoint.save(SortMethod::Polyphasic, mem_size, files, phase, writes);
+        }
+        if (phases == 0) {
+            checkpoint.save(SortMethod::Polyphasic, mem_size, files, 0, 0);
+        }
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        Checkpoint restarted(CHECKPOINT_PATH);
+        vector<vector<vector<int>>> resumed = restarted.load<int>(SortMethod::Polyphasic, num_files, mem_size, InputDigest::of(data));
+        ASSERT_DOUBLE_EQ(_polyphasic_sort_from_initial(resumed, mem_size, false, nullptr, &restarted).second, alpha);
+
+        // the public sort resumes too, and drops the manifest once done
+        checkpoint.save(SortMethod::Polyphasic, mem_size, files, checkpoint.phase(), checkpoint.writes());
+        Checkpoint restarted_sort(CHECKPOINT_PATH);
+        ASSERT_EQ(polyphasic_sort(data, num_files, mem_size, false, nullptr, &restarted_sort), expected);
+        ASSERT_FALSE(restarted_sort.exists());
+    }
+}
+
+TEST(test_checkpoint, parametrized_cascade_resume) {
+    for (int i = 0; i < 10; i++) {
+        const int num_files = RandomDataFixture::randint(3, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        vector<int> expected = data;
+        sort(expected.begin(), expected.end());
+
+        vector<vector<vector<int>>> files(num_files - 1);
+        perform_initial_distribution(data, files, mem_size);
+        files.emplace_back();
+        vector<vector<vector<int>>> uninterrupted = files;
+        const double alpha = _cascade_sort_from_initial(uninterrupted, mem_size, false).second;
+
+        Checkpoint checkpoint(CHECKPOINT_PATH);
+        checkpoint.set_input(InputDigest::of(data));
+        size_t writes = 0;
+        const int phases = RandomDataFixture::randint(1, 3);
+        for (int phase = 1; phase <= phases && !is_finished(files); phase++) {
+            writes += merge_step(files, mem_size);
+            writes += redistribute_if_needed(files);
+            checkpoint.save(SortMethod::Cascade, mem_size, files, phase, writes);
+        }
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        Checkpoint restarted(CHECKPOINT_PATH);
+        vector<vector<vector<int>>> resumed = restarted.load<int>(SortMethod::Cascade, num_files, mem_size, InputDigest::of(data));
+        ASSERT_DOUBLE_EQ(_cascade_sort_from_initial(resumed, mem_size, false, nullptr, &restarted).second, alpha);
+
+        checkpoint.save(SortMethod::Cascade, mem_size, files, checkpoint.phase(), checkpoint.writes());
+        Checkpoint restarted_sort(CHECKPOINT_PATH);
+        ASSERT_EQ(cascade_sort(data, num_files, mem_size, false, nullptr, &restarted_sort), expected);
+        ASSERT_FALSE(restarted_sort.exists());
+    }
+}
+
+TEST(test_checkpoint, test_sort_from_scratch) {
+    // with no manifest the sort starts from the input, and leaves nothing behind
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<int> expected = data;
+    sort(expected.begin(), expected.end());
+    Checkpoint checkpoint(CHECKPOINT_PATH);
+    checkpoint.clear();
+    ASSERT_EQ(cascade_sort(data, 3, 3, false, nullptr, &checkpoint), expected);
+    ASSERT_FALSE(checkpoint.exists());
+    ASSERT_EQ(polyphasic_sort(data, 3, 3, false, nullptr, &checkpoint), expected);
+    ASSERT_FALSE(checkpoint.exists());
+}
+
+TEST(test_checkpoint, test_other_input_is_rejected) {
+    // a manifest left by an interrupted sort is never applied to another input
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<int> other = data;
+    other[0] = 11;
+    for (const SortMethod method: {SortMethod::Polyphasic, SortMethod::Cascade}) {
+        vector<vector<vector<int>>> files(2);
+        perform_initial_distribution(data, files, 3);
+        files.emplace_back();
+        Checkpoint checkpoint(CHECKPOINT_PATH);
+        checkpoint.set_input(InputDigest::of(data));
+        checkpoint.save(method, 3, files, 0, 0);
+
+        Checkpoint restarted(CHECKPOINT_PATH);
+        if (method == SortMethod::Polyphasic) {
+            ASSERT_THROW(polyphasic_sort(other, 3, 3, false, nullptr, &restarted), std::invalid_argument);
+        } else {
+            ASSERT_THROW(cascade_sort(other, 3, 3, false, nullptr, &restarted), std::invalid_argument);
+        }
+        ASSERT_TRUE(restarted.exists());
+        restarted.clear();
+    }
+}
+
+// 4 bytes of padding after key
+struct PaddedRecord {
+    int key;
+    double weight;
+
+    bool operator<(const PaddedRecord& other) const {
+        return key < other.key;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const PaddedRecord& record) {
+        return os << record.key;
+    }
+};
+
+TEST(test_checkpoint, test_padded_records_are_rejected) {
+    const vector<PaddedRecord> data = {{3, 0.5}, {1, 1.5}, {2, 2.5}, {5, 3.5}};
+    Checkpoint checkpoint(CHECKPOINT_PATH);
+    checkpoint.clear();
+    ASSERT_THROW(InputDigest::of(data), std::invalid_argument);
+    ASSERT_THROW(cascade_sort(data, 3, 3, false, nullptr, &checkpoint), std::invalid_argument);
+    ASSERT_FALSE(checkpoint.exists());
+    // without a checkpoint the bytes of the records are never looked at
+    ASSERT_EQ(cascade_sort(data, 3, 3, false).front().key, 1);
+    // doubles have no padding
+    const vector<double> doubles = {0.5, -1.0, 2.0};
+    ASSERT_EQ(InputDigest::of(doubles), InputDigest::of(vector<double>(doubles)));
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
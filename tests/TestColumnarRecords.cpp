@@ -0,0 +1,146 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <tuple>
+#include <string>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "columnar_records.hpp"
+#include "hybrid_sort.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::tuple, std::sort;
+
+namespace {
+    // key that counts how many times it is compared
+    size_t comparisons = 0;
+
+    struct CountedKey {
+        int value;
+        bool operator<(const CountedKey& other) const {
+            ++comparisons;
+            return value < other.value;
+        }
+        bool operator==(const CountedKey& other) const { return value == other.value; }
+    };
+
+    using Records = ColumnarRecords<std::string, int, long long, int>;
+
+    // (tenant, timestamp, id) with few tenants and timestamps, so later keys often decide
+    Records random_records(const int size) {
+        Records records;
+        const vector<int> tenants = RandomDataFixture::random_vector(size, 0, 5);
+        const vector<int> timestamps = RandomDataFixture::random_vector(size, 0, 50);
+        const vector<int> ids = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        for (int i = 0; i < size; i++) {
+            records.push_back(tenants[i], timestamps[i], ids[i], "row " + std::to_string(i));
+        }
+        return records;
+    }
+
+    vector<tuple<int, long long, int, std::string>> rows(const Records& records) {
+        vector<tuple<int, long long, int, std::string>> result;
+        for (size_t i = 0; i < records.size(); i++) {
+            result.emplace_back(
+                records.key_column<0>()[i], records.key_column<1>()[i],
+                records.key_column<2>()[i], records.payload_column()[i]
+            );
+        }
+        return result;
+    }
+}
+
+TEST(test_columnar_records, test_row_less) {
+    Records records;
+    records.push_back(1, 20, 3, "a");
+    records.push_back(1, 10, 7, "b");
+    records.push_back(0, 30, 5, "c");
+    records.push_back(1, 10, 7, "d");
+    ASSERT_TRUE(records.row_less(2, 0));
+    ASSERT_TRUE(records.row_less(1, 0));
+    ASSERT_FALSE(records.row_less(0, 1));
+    // same keys
+    ASSERT_FALSE(records.row_less(1, 3));
+    ASSERT_FALSE(records.row_less(3, 1));
+
+    const Records reordered = records.gather({2, 1, 0});
+    ASSERT_EQ(reordered.size(), 3);
+    ASSERT_EQ(reordered.key_column<1>(), (vector<long long>{30, 10, 20}));
+    ASSERT_EQ(reordered.payload_column(), (vector<std::string>{"c", "b", "a"}));
+}
+
+TEST(test_columnar_records, test_later_keys_only_read_on_ties) {
+    // distinct leading keys: the handles decide every comparison on their own
+    ColumnarRecords<int, int, CountedKey> records;
+    const vector<int> leading = {5, 3, 9, 1, 7, 2, 8, 6, 4, 0};
+    for (const int key: leading) {
+        records.push_back(key, CountedKey{-key}, key);
+    }
+    comparisons = 0;
+    const auto sorted = columnar_sort(records, SortMethod::Polyphasic, 3, 3);
+    ASSERT_EQ(comparisons, 0);
+    ASSERT_EQ(sorted.payload_column(), (vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(test_columnar_records, parametrized_random_test_sort) {
+    const SortMethod methods[] = {SortMethod::Balanced, SortMethod::Polyphasic, SortMethod::Cascade};
+    for (int i = 0; i < 15; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const Records records = random_records(size);
+        const Records sorted = columnar_sort(records, methods[i % 3], num_files, mem_size);
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        // same rows (each payload still next to its keys), ordered by (tenant, timestamp, id)
+        vector<tuple<int, long long, int, std::string>> sorted_rows = rows(sorted), expected_rows = rows(records);
+        ASSERT_TRUE(std::is_sorted(sorted_rows.begin(), sorted_rows.end(), [](const auto& a, const auto& b) {
+            return std::tie(std::get<0>(a), std::get<1>(a), std::get<2>(a))
+                < std::tie(std::get<0>(b), std::get<1>(b), std::get<2>(b));
+        }));
+        sort(sorted_rows.begin(), sorted_rows.end());
+        sort(expected_rows.begin(), expected_rows.end());
+        ASSERT_EQ(sorted_rows, expected_rows);
+    }
+}
+
+TEST(test_columnar_records, test_run_tag_fits_in_the_handle) {
+    // the run tag is folded into the row: the replacement selection key is the handle itself
+    using Tagged = RunTagged<RowRef<Records>>;
+    ASSERT_EQ(sizeof(Tagged::Key), sizeof(RowRef<Records>));
+
+    const Records records;
+    const RowRef<Records> ref{3, 41, &records};
+    ASSERT_TRUE(Tagged::tag(Tagged::make(ref, true)));
+    ASSERT_FALSE(Tagged::tag(Tagged::make(ref, false)));
+    ASSERT_EQ(Tagged::value(Tagged::make(ref, true)).row, 41);
+    ASSERT_EQ(Tagged::value(Tagged::make(ref, true)).lead, 3);
+    ASSERT_EQ(Tagged::value(Tagged::make(ref, true)).records, &records);
+}
+
+TEST(test_columnar_records, test_handles_sort_on_other_threads) {
+    // few distinct leads, so most comparisons on the worker threads read the other key columns
+    const Records records = random_records(100000);
+    const auto& leading = records.key_column<0>();
+    vector<RowRef<Records>> refs;
+    for (size_t i = 0; i < records.size(); i++) {
+        refs.push_back({leading[i], i, &records});
+    }
+    const vector<RowRef<Records>> sorted = hybrid_sort(refs, SortMethod::Cascade, 4, refs.size(), 4);
+    ASSERT_EQ(sorted.size(), records.size());
+    for (size_t i = 1; i < sorted.size(); i++) {
+        ASSERT_FALSE(records.row_less(sorted[i].row, sorted[i - 1].row));
+    }
+}
+
+TEST(test_columnar_records, test_empty) {
+    const Records records;
+    ASSERT_EQ(columnar_sort(records, SortMethod::Cascade, 4, 3), records);
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <future>
+#include <algorithm>
+#include <sstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+#include "hybrid_sort.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+TEST(test_hybrid_sort, test_fits_in_memory) {
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9};
+    PhaseProfiler profiler;
+    const vector<int> sorted_data = hybrid_sort(data, SortMethod::Polyphasic, 3, data.size(), 1, &profiler);
+    vector<int> expected = data;
+    sort(expected.begin(), expected.end());
+    ASSERT_EQ(sorted_data, expected);
+    // no run formation, no merge phase
+    ASSERT_EQ(profiler.phases().size(), 1);
+    ASSERT_EQ(profiler.phases()[0].name, "in-memory");
+    ASSERT_EQ(profiler.phases()[0].records, data.size());
+}
+
+TEST(test_hybrid_sort, test_spills_one_past_memory) {
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1};
+    PhaseProfiler profiler;
+    const vector<int> sorted_data = hybrid_sort(data, SortMethod::Cascade, 3, data.size() - 1, 1, &profiler);
+    vector<int> expected = data;
+    sort(expected.begin(), expected.end());
+    ASSERT_EQ(sorted_data, expected);
+    ASSERT_EQ(profiler.phases()[0].name, "runs");
+    ASSERT_EQ(profiler.phases()[0].records, data.size());
+}
+
+TEST(test_hybrid_sort, test_empty) {
+    ASSERT_TRUE(hybrid_sort(vector<int>(), SortMethod::Balanced, 4, 3).empty());
+    ASSERT_THROW(hybrid_sort(vector<int>{1}, SortMethod::Balanced, 4, 1), std::invalid_argument);
+}
+
+TEST(test_hybrid_sort, test_input_stream) {
+    // single pass input: the buffered records cannot be read again after spilling
+    std::istringstream input("7 1 5 6 3 8 2 10 4 9 1 3 7 4 1 2 3");
+    const vector<int> sorted_data = hybrid_sort(
+        std::istream_iterator<int>(input), std::istream_iterator<int>(), SortMethod::Balanced, 4, 3
+    );
+    const vector<int> expected = {1, 1, 1, 2, 2, 3, 3, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10};
+    ASSERT_EQ(sorted_data, expected);
+}
+
+TEST(test_hybrid_sort, parametrized_parallel_in_memory) {
+    for (int i = 0; i < 5; i++) {
+        const int num_threads = RandomDataFixture::randint(2, 8);
+        const int size = RandomDataFixture::randint(1e5, 3e5);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e9, +1e9);
+        const vector<int> sorted_data = hybrid_sort(data, SortMethod::Cascade, 4, size, num_threads);
+        vector<int> expected_sorted_data = data;
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(sorted_data, expected_sorted_data);
+    }
+}
+
+TEST(test_hybrid_sort, test_parallel_with_caller_pool) {
+    // few distinct keys, so merge pieces split inside runs of equal records
+    ThreadPool pool(3);
+    for (const int size: {50000, 100000, 250000}) {
+        const vector<int> data = RandomDataFixture::random_vector(size, 0, 20);
+        vector<int> expected_sorted_data = data;
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+        ASSERT_EQ(hybrid_sort(data, SortMethod::Balanced, 4, size, pool), expected_sorted_data);
+    }
+}
+
+TEST(test_hybrid_sort, test_parallel_from_a_pool_task) {
+    // the only worker of the pool waits on the sort, which must still finish on the calling thread
+    ThreadPool pool(1);
+    const vector<int> data = RandomDataFixture::random_vector(100000, -1e9, +1e9);
+    std::promise<vector<int>> result;
+    pool.submit([&]() { result.set_value(hybrid_sort(data, SortMethod::Cascade, 4, data.size(), pool)); });
+    vector<int> expected_sorted_data = data;
+    sort(expected_sorted_data.begin(), expected_sorted_data.end());
+    ASSERT_EQ(result.get_future().get(), expected_sorted_data);
+}
+
+TEST(test_hybrid_sort, parametrized_random_test_spill) {
+    const SortMethod methods[] = {SortMethod::Balanced, SortMethod::Polyphasic, SortMethod::Cascade};
+    for (int i = 0; i < 15; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        const vector<int> sorted_data = hybrid_sort(data, methods[i % 3], num_files, mem_size);
+        vector<int> expected_sorted_data = data;
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(sorted_data, expected_sorted_data);
+    }
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "indexed_merge_sort.hpp"
+#include "balanced_sort.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+TEST(test_indexed_merge_sort, test_fan_in) {
+    ASSERT_EQ(merge_fan_in(1 << 20, DEFAULT_BLOCK_SIZE), 256);
+    ASSERT_EQ(merge_fan_in(100, 10), 10);
+    // never below a two-way merge, nor below the fan-in of the tapes
+    ASSERT_EQ(merge_fan_in(5, 10), 2);
+    ASSERT_EQ(merge_fan_in(1000, DEFAULT_BLOCK_SIZE, 4), 4);
+    ASSERT_EQ(merge_fan_in(100, 10, 4), 10);
+    ASSERT_THROW(merge_fan_in(5, 0), std::invalid_argument);
+}
+
+TEST(test_indexed_merge_sort, test_merge_pass) {
+    // a single tape with 5 runs: a 3-way merge reads 3 of them from the same tape
+    vector<IndexedTape<int>> input(1), output(2);
+    for (const vector<int>& run: vector<vector<int>>{{3, 9}, {1, 4}, {2, 8}, {5}, {0, 7}}) {
+        input[0].records.insert(input[0].records.end(), run.begin(), run.end());
+        input[0].end_run();
+    }
+    ASSERT_EQ(indexed_merge_pass(input, output, 3), 9);
+    ASSERT_EQ(output[0].num_runs(), 1);
+    ASSERT_EQ(output[1].num_runs(), 1);
+    ASSERT_EQ(output[0].records, (vector<int>{1, 2, 3, 4, 8, 9}));
+    ASSERT_EQ(output[1].records, (vector<int>{0, 5, 7}));
+}
+
+TEST(test_indexed_merge_sort, parametrized_random_test_sort) {
+    for (int i = 0; i < 20; i++) {
+        const int num_files = RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 4 * num_files + 1);
+        const int block_size = RandomDataFixture::randint(1, 4);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        const vector<int> sorted_data = indexed_merge_sort(data, num_files, mem_size, block_size, false);
+        vector<int> expected_sorted_data = data;
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(sorted_data, expected_sorted_data);
+    }
+}
+
+TEST(test_indexed_merge_sort, parametrized_passes_set_by_fan_in) {
+    for (int i = 0; i < 20; i++) {
+        // fan-in well above the number of files
+        const int num_files = RandomDataFixture::randint(2, 4);
+        const int mem_size = RandomDataFixture::randint(16, 64);
+        const size_t fan_in = merge_fan_in(mem_size, 2);
+        const int size = RandomDataFixture::randint(1e3, 2e4);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+
+        vector<vector<vector<int>>> files((num_files + 1) / 2);
+        perform_initial_distribution(data, files, mem_size);
+        vector<IndexedTape<int>> left(files.size()), right(num_files / 2);
+        size_t runs = 0;
+        for (size_t t = 0; t < files.size(); t++) {
+            for (const auto& run: files[t]) {
+                left[t].records.insert(left[t].records.end(), run.begin(), run.end());
+                left[t].end_run();
+                ++runs;
+            }
+        }
+        const double alpha = _indexed_merge_sort_from_initial(left, right, mem_size, fan_in, false).second;
+
+        // every pass writes every record once, and divides the runs by the fan-in
+        size_t passes = 0;
+        for (size_t remaining = runs; remaining > 1; remaining = (remaining + fan_in - 1) / fan_in) {
+            ++passes;
+        }
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_DOUBLE_EQ(alpha, double(passes));
+    }
+}
+
+TEST(test_indexed_merge_sort, parametrized_never_more_passes_than_balanced) {
+    for (int i = 0; i < 10; i++) {
+        // default block size, and budgets far below it (the first case is n = 2e5, m = 1000, k = 8)
+        const int num_files = i == 0 ? 8 : RandomDataFixture::randint(3, 10);
+        const int mem_size = i == 0 ? 1000 : RandomDataFixture::randint(num_files + 1, 2000);
+        const int size = i == 0 ? 2e5 : RandomDataFixture::randint(1e4, 5e4);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e9, +1e9);
+
+        vector<vector<vector<int>>> balanced_left((num_files + 1) / 2), balanced_right(num_files / 2);
+        perform_initial_distribution(data, balanced_left, mem_size);
+        vector<IndexedTape<int>> left(balanced_left.size()), right(std::max(1, num_files / 2));
+        for (size_t t = 0; t < balanced_left.size(); t++) {
+            for (const auto& run: balanced_left[t]) {
+                left[t].records.insert(left[t].records.end(), run.begin(), run.end());
+                left[t].end_run();
+            }
+        }
+        const size_t fan_in = merge_fan_in(mem_size, DEFAULT_BLOCK_SIZE, left.size());
+        const double indexed_alpha = _indexed_merge_sort_from_initial(left, right, mem_size, fan_in, false).second;
+        const double balanced_alpha = _balanced_sort_from_initial(balanced_left, balanced_right, mem_size, false).second;
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_LE(indexed_alpha, balanced_alpha);
+    }
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
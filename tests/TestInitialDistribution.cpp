@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 
 #include "initial_distribution.hpp"
+#include "simulation.hpp"
+#include "dary_heap.hpp"
 #include "utils.hpp"
 
 using std::vector, std::sort, std::cout, std::endl;
@@ -30,6 +32,198 @@ TEST(test_polyphasic_sort, test_initial_runs) {
     ASSERT_EQ(files, expected);
 }
 
+TEST(test_polyphasic_sort, test_mem_size_above_int_range) {
+    // a memory budget past 2^31 records must not wrap around (everything fits in a single run)
+    const size_t mem_size = 3'000'000'000ULL;
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<vector<vector<int>>> files(2);
+    perform_initial_distribution(data, files, mem_size);
+    vector<int> expected = data;
+    sort(expected.begin(), expected.end());
+    ASSERT_EQ(files[0].size(), 1);
+    ASSERT_EQ(files[0][0], expected);
+    ASSERT_TRUE(files[1].empty());
+}
+
+TEST(test_polyphasic_sort, test_avg_run_size_above_int_range) {
+    // total_runs * mem_size = 3 * 2^32 overflows a 32-bit product
+    const size_t mem_size = 1ULL << 32;
+    const vector<vector<vector<int>>> files = {
+        {{1, 2, 3}, {4, 5}},
+        {{6}}
+    };
+    const double expected = 6.0 / (3.0 * static_cast<double>(mem_size));
+    ASSERT_DOUBLE_EQ(Observer::avg_run_size(files, mem_size), expected);
+}
+
+TEST(test_polyphasic_sort, test_redistribution_writes_are_64_bit) {
+    vector<vector<vector<int>>> files = {{{1}, {2}, {3}}, {}, {}};
+    static_assert(sizeof(decltype(redistribute_if_needed(files))) >= 8);
+    ASSERT_EQ(redistribute_if_needed(files), 3);
+}
+
+TEST(test_polyphasic_sort, test_run_groups_match_run_lengths) {
+    // the grouped tapes describe exactly the runs dealt one by one
+    for (const size_t n: {0, 1, 6, 7, 1000, 1001}) {
+        const vector<RunLengthTape> lengths = initial_run_lengths(n, 4, 7);
+        const vector<RunGroupTape> groups = initial_run_groups(n, 4, 7);
+        for (size_t i = 0; i < 4; i++) {
+            RunGroupTape expected;
+            for (const size_t run: lengths[i]) {
+                expected.push_back(run);
+            }
+            ASSERT_EQ(groups[i].size(), lengths[i].size());
+            ASSERT_EQ(groups[i].groups(), expected.groups());
+        }
+    }
+}
+
+TEST(test_polyphasic_sort, test_initial_run_count_above_int_range) {
+    // 2^31 + 6 runs (the last one of 2 records) dealt into 3 files, without storing them
+    const size_t full_runs = (1ULL << 31) + 5;
+    const size_t n = 3 * full_runs + 2;
+    const vector<RunGroupTape> files = initial_run_groups(n, 3, 3);
+    ASSERT_EQ(files[0].groups(), (std::deque<RunGroupTape::Group>{{3, 715'827'885}}));
+    ASSERT_EQ(files[1].groups(), (std::deque<RunGroupTape::Group>{{3, 715'827'884}, {2, 1}}));
+    ASSERT_EQ(files[2].groups(), (std::deque<RunGroupTape::Group>{{3, 715'827'884}}));
+    ASSERT_EQ(files[0].size() + files[1].size() + files[2].size(), full_runs + 1);
+    ASSERT_EQ(files[0].records() + files[1].records() + files[2].records(), n);
+}
+
+TEST(test_polyphasic_sort, test_redistribution_above_int_range) {
+    // 3 * 2^31 + 2 runs on a single file: each other file takes a third, in order
+    const size_t runs = 3 * (1ULL << 31);
+    vector<RunGroupTape> files(4);
+    files[0].push_back(4, runs);
+    files[0].push_back(1, 2);
+    ASSERT_EQ(redistribute_if_needed(files), 4 * runs + 2);
+    ASSERT_TRUE(files[0].empty());
+    ASSERT_EQ(files[1].groups(), (std::deque<RunGroupTape::Group>{{4, (1ULL << 31) + 1}}));
+    ASSERT_EQ(files[2].groups(), (std::deque<RunGroupTape::Group>{{4, (1ULL << 31) + 1}}));
+    ASSERT_EQ(files[3].groups(), (std::deque<RunGroupTape::Group>{{4, (1ULL << 31) - 2}, {1, 2}}));
+    // nothing to do once the runs are spread
+    ASSERT_EQ(redistribute_if_needed(files), 0);
+}
+
+TEST(test_polyphasic_sort, test_avg_run_size_run_count_above_int_range) {
+    // 3 * 2^31 runs of 3 * 2^19 records with mem_size 2^20
+    vector<RunGroupTape> files(2);
+    files[0].push_back(3ULL << 19, 1ULL << 32);
+    files[1].push_back(3ULL << 19, 1ULL << 31);
+    ASSERT_DOUBLE_EQ(Observer::avg_run_size(files, 1ULL << 20), 1.5);
+}
+
+TEST(test_polyphasic_sort, test_dary_heap_order) {
+    srand(0);
+    vector<int> data(10000);
+    for (auto& x: data) x = rand() % 1000 - 500;
+    DaryHeap<int> heap, replaced_heap;
+    for (const int x: data) {
+        heap.push(x);
+        replaced_heap.push(x);
+    }
+    // replace_top must behave as a pop followed by a push
+    for (int i = 0; i < 100; i++) {
+        const int x = rand() % 1000 - 500;
+        heap.pop();
+        heap.push(x);
+        replaced_heap.replace_top(x);
+        data.push_back(x);
+    }
+    vector<int> result, replaced_result;
+    while (!heap.empty()) {
+        result.push_back(heap.top());
+        replaced_result.push_back(replaced_heap.top());
+        heap.pop();
+        replaced_heap.pop();
+    }
+    ASSERT_TRUE(std::is_sorted(result.begin(), result.end()));
+    ASSERT_EQ(result, replaced_result);
+    ASSERT_EQ(result.size(), 10000);
+}
+
+namespace {
+    // record without a default constructor
+    struct NoDefault {
+        explicit NoDefault(const int value) : value(value) {}
+        int value;
+        bool operator<(const NoDefault& other) const { return value < other.value; }
+        bool operator==(const NoDefault& other) const { return value == other.value; }
+    };
+}
+
+TEST(test_polyphasic_sort, test_dary_heap_alignment) {
+    // the 4 children of the root (and of every node) share a 16 byte block of a cache line
+    DaryHeap<int> heap;
+    for (int x = 0; x < 100; x++) heap.push(x);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&heap.top() + 1) % (4 * sizeof(int)), 0);
+    ASSERT_EQ((reinterpret_cast<std::uintptr_t>(&heap.top()) - 3 * sizeof(int)) % CACHE_LINE_SIZE, 0);
+}
+
+TEST(test_polyphasic_sort, test_initial_runs_without_default_constructor) {
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<NoDefault> records;
+    for (const int x: data) records.emplace_back(x);
+    vector<vector<vector<int>>> files(2);
+    vector<vector<vector<NoDefault>>> record_files(2);
+    perform_initial_distribution(data, files, 3);
+    perform_initial_distribution(records, record_files, 3);
+    for (size_t i = 0; i < files.size(); i++) {
+        ASSERT_EQ(files[i].size(), record_files[i].size());
+        for (size_t j = 0; j < files[i].size(); j++) {
+            vector<NoDefault> expected;
+            for (const int x: files[i][j]) expected.emplace_back(x);
+            ASSERT_EQ(record_files[i][j], expected);
+        }
+    }
+}
+
+TEST(test_polyphasic_sort, test_run_tagged_packed_keys) {
+    using Tagged = RunTagged<int>;
+    static_assert(sizeof(Tagged::Key) == 8);
+    Tagged::Less less;
+    const vector<int> values = {std::numeric_limits<int>::min(), -7, -1, 0, 1, 42, std::numeric_limits<int>::max()};
+    for (const int a: values) {
+        ASSERT_EQ(Tagged::value(Tagged::make(a, true)), a);
+        for (const int b: values) {
+            ASSERT_EQ(less(Tagged::make(a, false), Tagged::make(b, false)), a < b);
+            // records of the next run always sort last, until it becomes the current one
+            ASSERT_TRUE(less(Tagged::make(a, false), Tagged::make(b, true)));
+            less.set_current_run(true);
+            ASSERT_TRUE(less(Tagged::make(a, true), Tagged::make(b, false)));
+            ASSERT_EQ(less(Tagged::make(a, true), Tagged::make(b, true)), a < b);
+            less.set_current_run(false);
+        }
+    }
+}
+
+TEST(test_polyphasic_sort, test_initial_runs_unpacked_keys) {
+    // same runs whether the run tag is packed with the key (int) or not (long long)
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<vector<vector<int>>> files(2);
+    vector<vector<vector<long long>>> wide_files(2);
+    perform_initial_distribution(data, files, 3);
+    perform_initial_distribution(vector<long long>(data.begin(), data.end()), wide_files, 3);
+    ASSERT_EQ(files.size(), wide_files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        ASSERT_EQ(files[i].size(), wide_files[i].size());
+        for (size_t j = 0; j < files[i].size(); j++) {
+            ASSERT_EQ(vector<long long>(files[i][j].begin(), files[i][j].end()), wide_files[i][j]);
+        }
+    }
+}
+
+TEST(test_polyphasic_sort, test_initial_runs_from_buffered_records) {
+    // seeding the heap with records already read gives the same runs as reading them all
+    const int mem_size = 3;
+    const vector<int> data = {7, 1, 5, 6, 3, 8, 2, 10, 4, 9, 1, 3, 7, 4, 1, 2, 3};
+    vector<vector<vector<int>>> expected(2), files(2);
+    perform_initial_distribution(data, expected, mem_size);
+    const vector<int> buffered(data.begin(), data.begin() + 2);
+    perform_initial_distribution(buffered, data.begin() + 2, data.end(), files, mem_size);
+    ASSERT_EQ(files, expected);
+}
+
 int main() {
     testing::InitGoogleTest();
     return RUN_ALL_TESTS();
@@ -0,0 +1,203 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "merge_kernel.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+namespace {
+    vector<vector<int>> random_runs(const size_t fan_in, const int max_run_size, const int min_element, const int max_element) {
+        vector<vector<int>> runs(fan_in);
+        for (auto& run: runs) {
+            run = RandomDataFixture::random_vector(RandomDataFixture::randint(0, max_run_size), min_element, max_element);
+            sort(run.begin(), run.end());
+        }
+        return runs;
+    }
+
+    vector<const vector<int>*> pointers(const vector<vector<int>>& runs) {
+        vector<const vector<int>*> ptrs;
+        for (const auto& run: runs) {
+            ptrs.emplace_back(&run);
+        }
+        return ptrs;
+    }
+
+    // only the key takes part in the ordering, origin tells which run it came from
+    struct Tagged {
+        int key;
+        size_t origin;
+        bool operator<(const Tagged& other) const { return key < other.key; }
+        bool operator>(const Tagged& other) const { return other < *this; }
+    };
+
+    // same, small enough for the loser tree to cache heads by value
+    struct SmallTagged {
+        int key;
+        int origin;
+        bool operator<(const SmallTagged& other) const { return key < other.key; }
+        bool operator>(const SmallTagged& other) const { return other < *this; }
+    };
+
+    // record without a default constructor
+    struct NoDefault {
+        explicit NoDefault(const int key) : key(key) {}
+        int key;
+        bool operator<(const NoDefault& other) const { return key < other.key; }
+        bool operator>(const NoDefault& other) const { return other < *this; }
+    };
+}
+
+TEST(test_merge_kernel, parametrized_random_test_merge) {
+    for (int i = 0; i < 200; i++) {
+        const size_t fan_in = RandomDataFixture::randint(1, 2 * MAX_FIXED_FAN_IN);
+        const vector<vector<int>> runs = random_runs(fan_in, 50, -100, +100);
+        vector<int> expected;
+        for (const auto& run: runs) {
+            expected.insert(expected.end(), run.begin(), run.end());
+        }
+        sort(expected.begin(), expected.end());
+
+        vector<int> merged;
+        const size_t writes = merge_runs(pointers(runs), merged);
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i) + " with fan-in " + std::to_string(fan_in));
+        ASSERT_EQ(writes, expected.size());
+        ASSERT_EQ(merged, expected);
+    }
+}
+
+TEST(test_merge_kernel, test_fixed_matches_generic) {
+    const vector<vector<int>> runs = random_runs(7, 1000, -1e9, +1e9);
+    vector<int> fixed, generic;
+    ASSERT_EQ(merge_runs_fixed<7>(pointers(runs), fixed), merge_runs_generic(pointers(runs), generic));
+    ASSERT_EQ(fixed, generic);
+}
+
+TEST(test_merge_kernel, test_ties_follow_run_order) {
+    const vector<vector<Tagged>> runs = {
+        {{1, 0}, {3, 0}, {3, 0}},
+        {{1, 1}, {2, 1}, {3, 1}},
+        {{3, 2}},
+        {{0, 3}, {1, 3}}
+    };
+    vector<const vector<Tagged>*> ptrs;
+    for (const auto& run: runs) {
+        ptrs.emplace_back(&run);
+    }
+    const vector<size_t> expected_origins = {3, 0, 1, 3, 1, 0, 0, 1, 2};
+    vector<Tagged> fixed, generic;
+    merge_runs_fixed<4>(ptrs, fixed);
+    merge_runs_generic(ptrs, generic);
+    for (size_t i = 0; i < expected_origins.size(); i++) {
+        ASSERT_EQ(fixed[i].origin, expected_origins[i]);
+        ASSERT_EQ(generic[i].origin, expected_origins[i]);
+    }
+}
+
+TEST(test_merge_kernel, parametrized_presorted_test_merge) {
+    // runs made of long sorted blocks with many repeated keys, so single runs win long streaks
+    for (int i = 0; i < 200; i++) {
+        const size_t fan_in = RandomDataFixture::randint(1, 2 * MAX_FIXED_FAN_IN);
+        vector<vector<Tagged>> runs(fan_in);
+        for (size_t r = 0; r < fan_in; r++) {
+            int key = RandomDataFixture::randint(0, 10);
+            const int run_size = RandomDataFixture::randint(0, 500);
+            for (int j = 0; j < run_size; j++) {
+                if (RandomDataFixture::randint(0, 20) == 0) {
+                    key += RandomDataFixture::randint(0, 100);
+                }
+                runs[r].push_back({key, r});
+            }
+        }
+        // ties keep the order of the runs, like a stable sort of their concatenation
+        vector<Tagged> expected;
+        vector<const vector<Tagged>*> ptrs;
+        for (const auto& run: runs) {
+            expected.insert(expected.end(), run.begin(), run.end());
+            ptrs.emplace_back(&run);
+        }
+        std::stable_sort(expected.begin(), expected.end());
+
+        vector<Tagged> merged, generic;
+        ASSERT_EQ(merge_runs(ptrs, merged), expected.size());
+        ASSERT_EQ(merge_runs_generic(ptrs, generic), expected.size());
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i) + " with fan-in " + std::to_string(fan_in));
+        for (size_t j = 0; j < expected.size(); j++) {
+            ASSERT_EQ(merged[j].key, expected[j].key);
+            ASSERT_EQ(merged[j].origin, expected[j].origin);
+            ASSERT_EQ(generic[j].key, expected[j].key);
+            ASSERT_EQ(generic[j].origin, expected[j].origin);
+        }
+    }
+}
+
+TEST(test_merge_kernel, parametrized_cached_heads_keep_run_order) {
+    static_assert(sizeof(SmallTagged) <= sizeof(void*));
+    for (int i = 0; i < 50; i++) {
+        // few distinct keys, so most matches are ties
+        vector<vector<SmallTagged>> runs(MAX_FIXED_FAN_IN);
+        vector<SmallTagged> expected;
+        vector<const vector<SmallTagged>*> ptrs;
+        for (size_t r = 0; r < runs.size(); r++) {
+            for (const int key: RandomDataFixture::random_vector(RandomDataFixture::randint(0, 200), 0, 5)) {
+                runs[r].push_back({key, int(r)});
+            }
+            std::stable_sort(runs[r].begin(), runs[r].end());
+            expected.insert(expected.end(), runs[r].begin(), runs[r].end());
+            ptrs.emplace_back(&runs[r]);
+        }
+        std::stable_sort(expected.begin(), expected.end());
+
+        vector<SmallTagged> merged;
+        ASSERT_EQ(merge_runs_fixed<MAX_FIXED_FAN_IN>(ptrs, merged), expected.size());
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        for (size_t j = 0; j < expected.size(); j++) {
+            ASSERT_EQ(merged[j].key, expected[j].key);
+            ASSERT_EQ(merged[j].origin, expected[j].origin);
+        }
+    }
+}
+
+TEST(test_merge_kernel, test_merge_without_default_constructor) {
+    const vector<vector<int>> runs = random_runs(5, 200, -100, +100);
+    vector<vector<NoDefault>> records(runs.size());
+    vector<const vector<NoDefault>*> ptrs;
+    vector<int> expected;
+    for (size_t r = 0; r < runs.size(); r++) {
+        for (const int x: runs[r]) records[r].emplace_back(x);
+        ptrs.emplace_back(&records[r]);
+        expected.insert(expected.end(), runs[r].begin(), runs[r].end());
+    }
+    sort(expected.begin(), expected.end());
+
+    vector<NoDefault> fixed, generic;
+    ASSERT_EQ(merge_runs_fixed<5>(ptrs, fixed), expected.size());
+    ASSERT_EQ(merge_runs_generic(ptrs, generic), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(fixed[i].key, expected[i]);
+        ASSERT_EQ(generic[i].key, expected[i]);
+    }
+}
+
+TEST(test_merge_kernel, test_merge_spans) {
+    // runs stored back to back in a single buffer
+    const vector<int> tape = {1, 4, 9, 2, 3, 10, 0, 5};
+    const vector<RunSpan<int>> runs = {
+        {tape.data(), tape.data() + 3}, {tape.data() + 3, tape.data() + 6}, {tape.data() + 6, tape.data() + 8}
+    };
+    vector<int> merged;
+    ASSERT_EQ(merge_runs(runs, merged), tape.size());
+    ASSERT_EQ(merged, (vector<int>{0, 1, 2, 3, 4, 5, 9, 10}));
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
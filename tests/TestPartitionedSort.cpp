@@ -0,0 +1,102 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "partitioned_sort.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+TEST(test_partitioned_sort, test_splitters) {
+    vector<int> data(1000);
+    for (int i = 0; i < 1000; i++) data[i] = i;
+    const vector<int> splitters = choose_splitters(data, 4, 64);
+    ASSERT_EQ(splitters.size(), 3);
+    ASSERT_TRUE(std::is_sorted(splitters.begin(), splitters.end()));
+    // roughly at the quartiles
+    ASSERT_NEAR(splitters[0], 250, 100);
+    ASSERT_NEAR(splitters[1], 500, 100);
+    ASSERT_NEAR(splitters[2], 750, 100);
+    ASSERT_TRUE(choose_splitters(data, 1).empty());
+}
+
+TEST(test_partitioned_sort, parametrized_random_test_sort) {
+    const SortMethod methods[] = {SortMethod::Balanced, SortMethod::Polyphasic, SortMethod::Cascade};
+    for (int i = 0; i < 9; i++) {
+        const int num_workers = RandomDataFixture::randint(1, 6);
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 2e4);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e9, +1e9);
+        const vector<int> sorted_data = partitioned_sort(data, methods[i % 3], num_workers, num_files, mem_size);
+        vector<int> expected_sorted_data = data;
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(sorted_data, expected_sorted_data);
+    }
+}
+
+TEST(test_partitioned_sort, test_skewed_and_empty_input) {
+    // all records in one key range leaves the other workers with nothing to sort
+    const vector<int> equal(5000, 7);
+    ASSERT_EQ(partitioned_sort(equal, SortMethod::Cascade, 4, 4, 10), equal);
+    ASSERT_TRUE(partitioned_sort(vector<int>(), SortMethod::Balanced, 3, 4, 10).empty());
+}
+
+TEST(test_partitioned_sort, test_wide_records) {
+    vector<double> data(10000);
+    for (double& x: data) x = RandomDataFixture::randint(-1e6, 1e6) / 7.0;
+    vector<double> expected_sorted_data = data;
+    sort(expected_sorted_data.begin(), expected_sorted_data.end());
+    ASSERT_EQ(partitioned_sort(data, SortMethod::Polyphasic, 3, 6, 20), expected_sorted_data);
+}
+
+// sends only a header and closes the connection, so a worker that trusted it would fail reading records
+void expect_rejected(const PartitionDetail::RequestHeader& header, const size_t max_records = 1000) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    PartitionDetail::send_all(fds[0], &header, sizeof(header));
+    close(fds[0]);
+    EXPECT_THROW(serve_sort_request<int>(fds[1], max_records), std::invalid_argument);
+    close(fds[1]);
+}
+
+TEST(test_partitioned_sort, test_malformed_requests) {
+    expect_rejected({7, 4, 10, 100});
+    expect_rejected({0, 0, 10, 100});
+    expect_rejected({1, 1, 10, 100});
+    expect_rejected({2, 2, 10, 100});
+    expect_rejected({2, MAX_REQUEST_FILES + 1, 10, 100});
+    expect_rejected({0, 4, 0, 100});
+    expect_rejected({0, 4, 1, 100});
+    expect_rejected({1, 4, 10, 1001});
+    expect_rejected({1, 4, 10, std::uint64_t(1) << 62}, MAX_REQUEST_BYTES / sizeof(int));
+
+    ASSERT_THROW(partitioned_sort(vector<int>(10), SortMethod::Cascade, 2, 2, 10), std::invalid_argument);
+    ASSERT_THROW(partitioned_sort(vector<int>(10), SortMethod::Balanced, 2, 4, 1), std::invalid_argument);
+}
+
+TEST(test_partitioned_sort, test_valid_request) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    const vector<int> data = {5, 3, 9, 1, 7, 2, 8};
+    const PartitionDetail::RequestHeader header{static_cast<std::uint64_t>(SortMethod::Polyphasic), 3, 2, data.size()};
+    PartitionDetail::send_all(fds[0], &header, sizeof(header));
+    PartitionDetail::send_all(fds[0], data.data(), data.size() * sizeof(int));
+    serve_sort_request<int>(fds[1], data.size());
+    const vector<int> sorted_data = PartitionDetail::recv_records<int>(fds[0], data.size());
+    close(fds[0]);
+    close(fds[1]);
+    ASSERT_EQ(sorted_data, vector<int>({1, 2, 3, 5, 7, 8, 9}));
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
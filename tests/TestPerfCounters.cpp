@@ -0,0 +1,109 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "balanced_sort.hpp"
+#include "polyphasic_sort.hpp"
+#include "cascade_sort.hpp"
+#include "perf_counters.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector;
+
+// counters are either all missing, or cycles and instructions were counted on every phase that wrote records
+void check_counters(const PhaseProfiler& profiler) {
+    for (const PhaseProfile& phase: profiler.phases()) {
+        if (!profiler.available()) {
+            ASSERT_FALSE(phase.counters.cycles.has_value());
+            ASSERT_FALSE(phase.counters.instructions.has_value());
+            ASSERT_FALSE(phase.counters.llc_misses.has_value());
+            ASSERT_FALSE(phase.counters.branch_misses.has_value());
+            ASSERT_FALSE(phase.ipc().has_value());
+        } else if (phase.records > 0) {
+            ASSERT_TRUE(phase.counters.cycles.has_value());
+            ASSERT_TRUE(phase.counters.instructions.has_value());
+            ASSERT_GT(*phase.counters.cycles, 0u);
+            ASSERT_GT(*phase.counters.instructions, 0u);
+            ASSERT_TRUE(phase.ipc().has_value());
+        }
+    }
+}
+
+TEST(test_perf_counters, test_phase_ratios) {
+    PhaseProfile phase{"merge 1", 10, {}};
+    ASSERT_FALSE(phase.ipc().has_value());
+    ASSERT_FALSE(phase.llc_misses_per_record().has_value());
+
+    phase.counters = {200, 100, 50, 20};
+    ASSERT_DOUBLE_EQ(*phase.ipc(), 0.5);
+    ASSERT_DOUBLE_EQ(*phase.llc_misses_per_record(), 5.0);
+    ASSERT_DOUBLE_EQ(*phase.branch_misses_per_record(), 2.0);
+}
+
+TEST(test_perf_counters, test_report_format) {
+    PhaseProfiler profiler;
+    profiler.begin("runs");
+    profiler.end(0);
+    std::ostringstream os;
+    profiler.report(os);
+    // no records: per record values are never defined
+    ASSERT_NE(os.str().find("runs:"), std::string::npos);
+    ASSERT_NE(os.str().find("llc-misses/record n/a"), std::string::npos);
+}
+
+TEST(test_perf_counters, parametrized_balanced_phases) {
+    for (int i = 0; i < 10; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 6);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+
+        vector<vector<vector<int>>> left(num_files / 2), right(num_files / 2);
+        perform_initial_distribution(data, left, mem_size);
+        PhaseProfiler profiler;
+        const auto[sorted_data, alpha] = _balanced_sort_from_initial(left, right, mem_size, false, &profiler);
+
+        size_t records = 0;
+        for (const PhaseProfile& phase: profiler.phases()) {
+            ASSERT_EQ(phase.name, "merge " + std::to_string(&phase - &profiler.phases()[0] + 1));
+            records += phase.records;
+        }
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_FALSE(profiler.phases().empty());
+        ASSERT_DOUBLE_EQ(double(records) / double(size), alpha);
+        ASSERT_TRUE(std::is_sorted(sorted_data.begin(), sorted_data.end()));
+        check_counters(profiler);
+    }
+}
+
+TEST(test_perf_counters, parametrized_sorts_record_run_formation) {
+    for (int i = 0; i < 10; i++) {
+        const int num_files = RandomDataFixture::randint(3, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+        vector<int> expected = data;
+        std::sort(expected.begin(), expected.end());
+
+        PhaseProfiler balanced, polyphasic, cascade;
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(balanced_sort(data, num_files, mem_size, false, &balanced), expected);
+        ASSERT_EQ(polyphasic_sort(data, num_files, mem_size, false, &polyphasic), expected);
+        ASSERT_EQ(cascade_sort(data, num_files, mem_size, false, &cascade), expected);
+        for (const PhaseProfiler* profiler: {&balanced, &polyphasic, &cascade}) {
+            ASSERT_GE(profiler->phases().size(), 2);
+            ASSERT_EQ(profiler->phases()[0].name, "runs");
+            ASSERT_EQ(profiler->phases()[0].records, size_t(size));
+            check_counters(*profiler);
+        }
+    }
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
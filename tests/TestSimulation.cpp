@@ -0,0 +1,109 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "simulation.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector;
+
+TEST(test_simulation, test_initial_run_lengths) {
+    const vector<RunLengthTape> expected = {{4, 4}, {4, 1}, {4}};
+    ASSERT_EQ(initial_run_lengths(17, 3, 4), expected);
+}
+
+TEST(test_simulation, parametrized_matches_balanced_sort) {
+    for (int i = 0; i < 20; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+
+        vector<vector<vector<int>>> left(num_files / 2), right(num_files / 2);
+        perform_initial_distribution(data, left, mem_size);
+        const SimulationReport report = simulate_balanced_from_initial(to_run_lengths(left), right.size(), mem_size);
+        const double alpha = _balanced_sort_from_initial(left, right, mem_size, false).second;
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(report.n, size);
+        ASSERT_DOUBLE_EQ(report.alpha, alpha);
+    }
+}
+
+TEST(test_simulation, parametrized_matches_polyphasic_sort) {
+    for (int i = 0; i < 20; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+
+        vector<vector<vector<int>>> files(num_files - 1);
+        perform_initial_distribution(data, files, mem_size);
+        files.emplace_back();
+        const SimulationReport report = simulate_polyphasic_from_initial(to_run_lengths(files), mem_size);
+        const double alpha = _polyphasic_sort_from_initial(files, mem_size, false).second;
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(report.n, size);
+        ASSERT_DOUBLE_EQ(report.alpha, alpha);
+    }
+}
+
+TEST(test_simulation, parametrized_matches_cascade_sort) {
+    for (int i = 0; i < 20; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 10);
+        const int mem_size = RandomDataFixture::randint(num_files + 1, 2 * num_files + 1);
+        const int size = RandomDataFixture::randint(1e3, 5e3);
+        const vector<int> data = RandomDataFixture::random_vector(size, -1e5, +1e5);
+
+        vector<vector<vector<int>>> files(num_files - 1);
+        perform_initial_distribution(data, files, mem_size);
+        files.emplace_back();
+        const SimulationReport report = simulate_cascade_from_initial(to_run_lengths(files), mem_size);
+        const double alpha = _cascade_sort_from_initial(files, mem_size, false).second;
+
+        SCOPED_TRACE("FAILED TESTCASE " + std::to_string(i));
+        ASSERT_EQ(report.n, size);
+        ASSERT_DOUBLE_EQ(report.alpha, alpha);
+    }
+}
+
+TEST(test_simulation, test_balanced_records_above_int_range) {
+    // 3 * 10^9 records in 1500 runs of 2 * 10^6, merged 4 at a time:
+    // 1500 -> 375 -> 94 -> 24 -> 6 -> 2 -> 1, every pass rewrites all records
+    const size_t n = 3'000'000'000ULL;
+    const SimulationReport report = simulate_sort(SortMethod::Balanced, n, 8, 1'000'000);
+    ASSERT_EQ(report.initial_runs, 1500);
+    ASSERT_EQ(report.passes, 6);
+    for (const size_t writes: report.writes_per_phase) {
+        ASSERT_EQ(writes, n);
+    }
+    ASSERT_DOUBLE_EQ(report.alpha, 6.0);
+}
+
+TEST(test_simulation, test_write_counters_above_int_range) {
+    // 2^32 records in 2^12 runs merged pairwise: 12 passes, each writing 2^32 records
+    const size_t n = 1ULL << 32;
+    const SimulationReport report = simulate_sort(SortMethod::Balanced, n, 4, 2, 1 << 20);
+    ASSERT_EQ(report.initial_runs, 1ULL << 12);
+    ASSERT_EQ(report.passes, 12);
+
+    for (const SortMethod method: {SortMethod::Polyphasic, SortMethod::Cascade}) {
+        const SimulationReport other = simulate_sort(method, n, 8, 1'000'000);
+        size_t total_writes = 0;
+        for (const size_t writes: other.writes_per_phase) {
+            total_writes += writes;
+        }
+        ASSERT_EQ(other.n, n);
+        ASSERT_GT(total_writes, n);
+        ASSERT_DOUBLE_EQ(other.alpha, double(total_writes) / double(n));
+    }
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
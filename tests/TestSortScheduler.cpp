@@ -0,0 +1,101 @@
+//
+// Created by igor-borja on 10/19/26.
+//
+#include <vector>
+#include <future>
+#include <atomic>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+#include "sort_scheduler.hpp"
+#include "RandomDataFixture.hpp"
+
+using std::vector, std::sort;
+
+TEST(test_sort_scheduler, test_thread_pool_nested_tasks) {
+    std::atomic<int> done{0};
+    {
+        ThreadPool pool(4);
+        for (int i = 0; i < 100; i++) {
+            // tasks spawned from workers go to their own deque and can be stolen
+            pool.submit([&pool, &done]() {
+                for (int j = 0; j < 10; j++) {
+                    pool.submit([&done]() { ++done; });
+                }
+                ++done;
+            });
+        }
+    }
+    ASSERT_EQ(done.load(), 1100);
+}
+
+TEST(test_sort_scheduler, test_thread_pool_defer) {
+    // a deferred task runs after the tasks already queued by the same worker
+    vector<int> order;
+    {
+        ThreadPool pool(1);
+        pool.submit([&pool, &order]() {
+            pool.submit([&order]() { order.push_back(1); });
+            pool.defer([&order]() { order.push_back(2); });
+            pool.submit([&order]() { order.push_back(3); });
+        });
+    }
+    ASSERT_EQ(order, vector<int>({3, 1, 2}));
+}
+
+TEST(test_sort_scheduler, parametrized_concurrent_jobs) {
+    const size_t mem_size = 40, max_size = 5000;
+    // room for about 3 of the largest jobs at once
+    const size_t capacity = 3 * (2 * max_size + mem_size);
+    SortScheduler scheduler(4, capacity);
+    const SortMethod methods[] = {SortMethod::Balanced, SortMethod::Polyphasic, SortMethod::Cascade};
+
+    vector<vector<int>> inputs;
+    vector<std::future<vector<int>>> results;
+    size_t largest_job = 0;
+    for (int i = 0; i < 30; i++) {
+        const int num_files = 2 * RandomDataFixture::randint(2, 6);
+        const int size = RandomDataFixture::randint(0, max_size);
+        inputs.emplace_back(RandomDataFixture::random_vector(size, -1e5, +1e5));
+        results.emplace_back(scheduler.submit(methods[i % 3], inputs.back(), num_files, mem_size));
+        largest_job = std::max(largest_job, 2 * size + mem_size);
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        vector<int> expected_sorted_data = inputs[i];
+        sort(expected_sorted_data.begin(), expected_sorted_data.end());
+        SCOPED_TRACE("FAILED JOB " + std::to_string(i));
+        ASSERT_EQ(results[i].get(), expected_sorted_data);
+    }
+    // every job is charged its records, not only its working memory
+    ASSERT_GE(scheduler.memory().peak(), largest_job);
+    ASSERT_LE(scheduler.memory().peak(), capacity);
+    ASSERT_EQ(scheduler.memory().in_use(), 0);
+}
+
+TEST(test_sort_scheduler, test_memory_budget_admission) {
+    MemoryBudget budget(10);
+    vector<int> granted;
+    budget.acquire(6, [&granted]() { granted.push_back(1); });
+    budget.acquire(6, [&granted]() { granted.push_back(2); });
+    budget.acquire(3, [&granted]() { granted.push_back(3); });
+    // only the first fits, and the small request waits behind the older one
+    ASSERT_EQ(granted, vector<int>({1}));
+    budget.release(6);
+    ASSERT_EQ(granted, vector<int>({1, 2, 3}));
+    ASSERT_EQ(budget.in_use(), 9);
+    ASSERT_EQ(budget.peak(), 9);
+    ASSERT_THROW(budget.acquire(11, []() {}), std::invalid_argument);
+}
+
+TEST(test_sort_scheduler, test_job_larger_than_budget) {
+    SortScheduler scheduler(2, 10);
+    ASSERT_THROW(scheduler.submit(SortMethod::Cascade, vector<int>{3, 2, 1}, 4, 20), std::invalid_argument);
+    // 2 * 3 records plus 5 of working memory do not fit in 10
+    ASSERT_THROW(scheduler.submit(SortMethod::Cascade, vector<int>{3, 2, 1}, 4, 5), std::invalid_argument);
+    ASSERT_EQ(scheduler.submit(SortMethod::Cascade, vector<int>{3, 2, 1}, 4, 4).get(), vector<int>({1, 2, 3}));
+}
+
+int main() {
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}